@@ -0,0 +1,338 @@
+﻿// Pomiary szybkości reguł gry (generatora położeń i bota) na stałych stanach testowych i ziarnach,
+// żeby wyniki dało się porównywać między wersjami.
+//
+//   Bench [--quick] [--csv] [--filter tekst]
+//
+// Każdy pomiar jest powtarzany REPEATS razy, podajemy najlepszy i medianę
+// (ns na operację). --csv wypisuje to samo jako CSV na standardowe wyjście,
+// --quick skraca pomiary dziesięciokrotnie, --filter zostawia pomiary,
+// których nazwa zawiera tekst.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "BatchEval.h"
+#include "Bot.h"
+#include "Engine.h"
+#include "Fixtures.h"
+#include "Placement.h"
+#include "VecEnv.h"
+
+const int REPEATS = 5;
+const uint64_t GAME_SEED = 1;
+const int GAME_MAX_PIECES = 2000;
+
+// Wyniki trafiają tutaj, żeby kompilator nie wyrzucił mierzonej pracy
+static volatile int64_t g_sink;
+
+struct BenchResult {
+    const char* name;
+    int64_t ops;          // operacji w jednym powtórzeniu
+    double bestNs;        // ns na operację, najlepsze powtórzenie
+    double medianNs;
+    double perSec;        // pomiary całych gier: figury/s
+    double gamesPerSec;
+};
+
+struct BenchConfig {
+    bool quick = false;
+    bool csv = false;
+    const char* filter = nullptr;
+};
+
+static double seconds(std::chrono::steady_clock::time_point t0) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+}
+
+// Uruchamia fn REPEATS razy; fn zwraca liczbę wykonanych operacji
+template <typename Fn>
+static BenchResult measure(const char* name, Fn fn) {
+    double times[REPEATS];
+    int64_t ops = 0;
+    for (int r = 0; r < REPEATS; ++r) {
+        auto t0 = std::chrono::steady_clock::now();
+        ops = fn();
+        times[r] = seconds(t0);
+    }
+    std::sort(times, times + REPEATS);
+    BenchResult res = { name, ops, 0, 0, 0, 0 };
+    res.bestNs = times[0] * 1e9 / (double)ops;
+    res.medianNs = times[REPEATS / 2] * 1e9 / (double)ops;
+    res.perSec = (double)ops / times[REPEATS / 2];
+    return res;
+}
+
+// Wszystkie położenia figur mieszczące się w ramce planszy
+static std::vector<Piece> allPlacements() {
+    std::vector<Piece> out;
+    for (int shape = 0; shape < 7; ++shape)
+        for (int rot = 0; rot < 4; ++rot)
+            for (int y = -2; y < BOARD_H; ++y)
+                for (int x = -2; x < BOARD_W; ++x)
+                    out.push_back(Piece{ x, y, shape, rot });
+    return out;
+}
+
+static BenchResult benchCollision(const char* name, const char* fixture, int scale) {
+    GameState s;
+    makeFixture(fixture, s);
+    std::vector<Piece> pieces = allPlacements();
+    return measure(name, [&]() {
+        int64_t hits = 0;
+        for (int i = 0; i < scale; ++i)
+            for (const Piece& p : pieces)
+                hits += isCollision(s.board, p);
+        g_sink = hits;
+        return (int64_t)scale * (int64_t)pieces.size();
+    });
+}
+
+static BenchResult benchPieceBlocks(int scale) {
+    std::vector<Piece> pieces = allPlacements();
+    return measure("getPieceBlocks", [&]() {
+        int64_t sum = 0;
+        Block blocks[4];
+        for (int i = 0; i < scale; ++i) {
+            for (const Piece& p : pieces) {
+                getPieceBlocks(p, blocks);
+                sum += blocks[3].x + blocks[3].y;
+            }
+        }
+        g_sink = sum;
+        return (int64_t)scale * (int64_t)pieces.size();
+    });
+}
+
+// clearLines na kopii stanu z n pełnymi wierszami; kopia jest wliczona w czas
+static BenchResult benchClearLines(const char* name, const char* fixture, int count) {
+    GameState base;
+    makeFixture(fixture, base);
+    return measure(name, [&]() {
+        int64_t lines = 0;
+        for (int i = 0; i < count; ++i) {
+            GameState s = base;
+            lines += clearLines(s).count;
+        }
+        g_sink = lines;
+        return (int64_t)count;
+    });
+}
+
+// hardDrop z blokadą, czyszczeniem i nową figurą, na kopii stanu
+static BenchResult benchHardDrop(const char* name, const char* fixture, int count) {
+    GameState base;
+    makeFixture(fixture, base);
+    return measure(name, [&]() {
+        int64_t score = 0;
+        for (int i = 0; i < count; ++i) {
+            GameState s = base;
+            hardDrop(s);
+            score += s.pieces;
+        }
+        g_sink = score;
+        return (int64_t)count;
+    });
+}
+
+// Wszystkie położenia końcowe każdej z 7 figur ze startu; operacją jest
+// jedno wywołanie generate
+static BenchResult benchPlacements(const char* name, const char* fixture, int count) {
+    GameState base;
+    makeFixture(fixture, base);
+    static PlacementGenerator gen;
+    return measure(name, [&]() {
+        int64_t total = 0;
+        for (int i = 0; i < count; ++i) {
+            Piece p = base.currentPiece;
+            p.shape = i % 7;
+            total += gen.generate(base.board, p);
+        }
+        g_sink = total;
+        return (int64_t)count;
+    });
+}
+
+// Plansze po każdym położeniu każdej figury na stanie "mid", maski wierszy
+// w układzie evaluateBatch
+static int placementBoards(std::vector<uint16_t>& rows) {
+    GameState base;
+    makeFixture("mid", base);
+    PlacementGenerator gen;
+    std::vector<Board> boards;
+    for (int shape = 0; shape < 7; ++shape) {
+        int n = gen.generate(base.board, spawnPosition(shape));
+        for (int i = 0; i < n; ++i) {
+            GameState s = base;
+            s.currentPiece = gen.placement(i);
+            lockPiece(s);
+            clearLines(s);
+            boards.push_back(s.board);
+        }
+    }
+    size_t count = boards.size();
+    rows.resize(BOARD_H * count);
+    for (size_t i = 0; i < count; ++i)
+        for (int y = 0; y < BOARD_H; ++y)
+            rows[y * count + i] = boards[i].rows[y];
+    return (int)count;
+}
+
+// Ocena plansz: wszystkie naraz danym jądrem evaluateBatch; operacją jest plansza
+static BenchResult benchEval(const char* name, BatchKernel kernel, int repeats) {
+    std::vector<uint16_t> rows;
+    int count = placementBoards(rows);
+    std::vector<float> scores(count);
+    EvalWeights weights;
+    return measure(name, [&]() {
+        for (int r = 0; r < repeats; ++r)
+            evaluateBatch(rows.data(), count, count, weights, scores.data(), kernel);
+        g_sink = (int64_t)scores[0];
+        return (int64_t)count * repeats;
+    });
+}
+
+// Decyzja bota (domyślna głębokość i wiązka) dla bieżącej figury stanu testowego
+static BenchResult benchBot(const char* name, const char* fixture, int count) {
+    GameState base;
+    makeFixture(fixture, base);
+    static Bot bot;
+    return measure(name, [&]() {
+        Action path[64];
+        int64_t total = 0;
+        for (int i = 0; i < count; ++i)
+            total += bot.think(base, path, 64);
+        g_sink = total;
+        return (int64_t)count;
+    });
+}
+
+// Krok VecEnv: ENVS gier, losowe akcje; operacją jest krok jednej gry
+static BenchResult benchEnv(int steps) {
+    const int ENVS = 256;
+    VecEnv env(ENVS);
+    std::vector<uint64_t> seeds(ENVS);
+    for (int i = 0; i < ENVS; ++i)
+        seeds[i] = deriveSeed(GAME_SEED, (uint64_t)i);
+    std::vector<float> obs((size_t)ENVS * OBS_SIZE);
+    std::vector<float> rewards(ENVS);
+    std::vector<uint8_t> dones(ENVS);
+    std::vector<Action> actions(ENVS);
+    env.reset(seeds.data(), obs.data());
+    Rng rng;
+    seedRng(rng, GAME_SEED);
+    return measure("env/step", [&]() {
+        for (int t = 0; t < steps; ++t) {
+            for (int i = 0; i < ENVS; ++i)
+                actions[i] = (Action)nextBelow(rng, ACT_COUNT);
+            env.step(actions.data(), obs.data(), rewards.data(), dones.data());
+        }
+        g_sink = dones[0];
+        return (int64_t)steps * ENVS;
+    });
+}
+
+// Całe gry gracza losowego (jak w Simulator) z ziaren deriveSeed(GAME_SEED, i);
+// operacją jest figura
+static BenchResult benchGames(int games) {
+    int64_t totalPieces = 0;
+    BenchResult res = measure("game/random", [&]() {
+        Action actions[16];
+        totalPieces = 0;
+        for (int g = 0; g < games; ++g) {
+            GameState s;
+            resetBoard(s, deriveSeed(GAME_SEED, (uint64_t)g));
+            spawnNewPiece(s);
+            Rng player = s.rng;
+            rngJump(player);
+            while (!s.gameOver && s.pieces < GAME_MAX_PIECES) {
+                uint32_t r = nextU32(player);
+                int n = 0;
+                for (int i = 0; i < (int)(r & 3); ++i)
+                    actions[n++] = ACT_ROTATE;
+                int dx = (int)((r >> 8) % BOARD_W) - BOARD_W / 2;
+                for (int i = 0; i < (dx < 0 ? -dx : dx); ++i)
+                    actions[n++] = dx < 0 ? ACT_LEFT : ACT_RIGHT;
+                actions[n++] = ACT_HARD_DROP;
+                step(s, actions, n);
+            }
+            totalPieces += s.pieces;
+        }
+        g_sink = totalPieces;
+        return totalPieces;
+    });
+    res.gamesPerSec = res.perSec * (double)games / (double)totalPieces;
+    return res;
+}
+
+static bool parseArgs(int argc, char** argv, BenchConfig& cfg) {
+    for (int i = 1; i < argc; ++i) {
+        const char* a = argv[i];
+        if (!strcmp(a, "--quick"))                          cfg.quick = true;
+        else if (!strcmp(a, "--csv"))                       cfg.csv = true;
+        else if (!strcmp(a, "--filter") && i + 1 < argc)    cfg.filter = argv[++i];
+        else {
+            fprintf(stderr, "Nieznany argument: %s\n", a);
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char** argv) {
+    BenchConfig cfg;
+    if (!parseArgs(argc, argv, cfg)) {
+        fprintf(stderr, "Uzycie: %s [--quick] [--csv] [--filter tekst]\n", argv[0]);
+        return 1;
+    }
+    const int scale = cfg.quick ? 1 : 10;
+
+    struct Entry {
+        const char* name;
+        BenchResult (*run)(int scale);
+    };
+    static const Entry ENTRIES[] = {
+        { "isCollision/empty", [](int k) { return benchCollision("isCollision/empty", "empty", 20 * k); } },
+        { "isCollision/full",  [](int k) { return benchCollision("isCollision/full", "full", 20 * k); } },
+        { "getPieceBlocks",    [](int k) { return benchPieceBlocks(20 * k); } },
+        { "clearLines/0",      [](int k) { return benchClearLines("clearLines/0", "clear0", 100000 * k); } },
+        { "clearLines/1",      [](int k) { return benchClearLines("clearLines/1", "clear1", 100000 * k); } },
+        { "clearLines/2",      [](int k) { return benchClearLines("clearLines/2", "clear2", 100000 * k); } },
+        { "clearLines/3",      [](int k) { return benchClearLines("clearLines/3", "clear3", 100000 * k); } },
+        { "clearLines/4",      [](int k) { return benchClearLines("clearLines/4", "clear4", 100000 * k); } },
+        { "hardDrop/empty",    [](int k) { return benchHardDrop("hardDrop/empty", "empty", 100000 * k); } },
+        { "hardDrop/mid",      [](int k) { return benchHardDrop("hardDrop/mid", "mid", 100000 * k); } },
+        { "placements/empty",  [](int k) { return benchPlacements("placements/empty", "empty", 1000 * k); } },
+        { "placements/mid",    [](int k) { return benchPlacements("placements/mid", "mid", 1000 * k); } },
+        { "eval/scalar",       [](int k) { return benchEval("eval/scalar", BATCH_SCALAR, 100 * k); } },
+        { "eval/batch",        [](int k) { return benchEval("eval/batch", BATCH_AUTO, 100 * k); } },
+        { "bot/mid",           [](int k) { return benchBot("bot/mid", "mid", 20 * k); } },
+        { "env/step",          [](int k) { return benchEnv(100 * k); } },
+        { "game/random",       [](int k) { return benchGames(100 * k); } },
+    };
+
+    if (cfg.csv)
+        printf("name,ops,best_ns_per_op,median_ns_per_op,ops_per_sec,games_per_sec\n");
+    else
+        printf("%-20s %12s %12s %14s %10s\n", "pomiar", "best [ns]", "mediana [ns]", "operacje/s", "gry/s");
+
+    for (const Entry& e : ENTRIES) {
+        if (cfg.filter && !strstr(e.name, cfg.filter))
+            continue;
+        BenchResult r = e.run(scale);
+        if (cfg.csv) {
+            printf("%s,%lld,%.3f,%.3f,%.0f,%.1f\n", r.name, (long long)r.ops, r.bestNs, r.medianNs,
+                   r.perSec, r.gamesPerSec);
+        } else {
+            printf("%-20s %12.2f %12.2f %14.0f", r.name, r.bestNs, r.medianNs, r.perSec);
+            if (r.gamesPerSec > 0)
+                printf(" %10.1f", r.gamesPerSec);
+            printf("\n");
+        }
+        fflush(stdout);
+    }
+    return 0;
+}
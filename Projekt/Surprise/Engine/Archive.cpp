@@ -0,0 +1,352 @@
+﻿#include "Archive.h"
+
+#include <cstdio>
+#include <cstring>
+
+#include "ByteIO.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static const uint8_t ARCHIVE_MAGIC[4] = { 'T', 'A', 'R', 'C' };
+static const uint32_t ARCHIVE_VERSION = 2;   // 2: stan grawitacji w klatkach
+static const size_t ARCHIVE_HEADER_SIZE = 4 + 4 + 4 + 4 + 8;
+static const size_t ARCHIVE_ENTRY_SIZE = 8 + 4 + 8 + 4 + 4 * 4;
+static const size_t KEYFRAME_SIZE = 4 * 4 + SNAPSHOT_SIZE;
+
+// --- Klatki kluczowe ---
+
+void encodeSnapshot(const GameState& s, std::vector<uint8_t>& out) {
+    for (int y = 0; y < BOARD_H; ++y)
+        putU16(out, s.board.rows[y]);
+    out.insert(out.end(), &s.board.colors[0][0], &s.board.colors[0][0] + sizeof(s.board.colors));
+    out.push_back((uint8_t)(int8_t)s.currentPiece.x);
+    out.push_back((uint8_t)(int8_t)s.currentPiece.y);
+    out.push_back((uint8_t)s.currentPiece.shape);
+    out.push_back((uint8_t)s.currentPiece.rot);
+    for (int i = 0; i < 4; ++i)
+        putU32(out, s.rng.s[i]);
+    out.push_back((uint8_t)s.randomizer);
+    out.push_back((uint8_t)s.bagPos);
+    out.insert(out.end(), s.bag, s.bag + 7);
+    out.push_back(s.gameOver ? 1 : 0);
+    putU32(out, (uint32_t)s.score);
+    putU32(out, (uint32_t)s.lines);
+    putU32(out, (uint32_t)s.pieces);
+    putU32(out, (uint32_t)s.combo);
+    putU64(out, s.seed);
+    putU32(out, s.ticks);
+    putU16(out, (uint16_t)s.gravityAcc);
+    out.push_back((uint8_t)s.lockTicks);
+}
+
+bool decodeSnapshot(const uint8_t* p, GameState& s) {
+    // pola, którymi potem indeksuje się tablice, muszą mieć sens zanim trafią do stanu
+    const uint8_t* piece = p + BOARD_H * 2 + sizeof(s.board.colors);
+    const uint8_t* bag = piece + 4 + 16;
+    if (piece[2] >= 7 || piece[3] > 3)
+        return false;
+    if (bag[0] > RANDOMIZER_BAG7 || bag[1] > 7)
+        return false;
+    for (int i = 0; i < 7; ++i) {
+        if (bag[2 + i] >= 7)
+            return false;
+    }
+
+    for (int y = 0; y < BOARD_H; ++y, p += 2)
+        s.board.rows[y] = getU16(p);
+    std::memcpy(s.board.colors, p, sizeof(s.board.colors));
+    p += sizeof(s.board.colors);
+    recomputeHeights(s.board);
+    recomputeHash(s.board);
+    s.currentPiece.x = (int8_t)p[0];
+    s.currentPiece.y = (int8_t)p[1];
+    s.currentPiece.shape = p[2];
+    s.currentPiece.rot = p[3];
+    p += 4;
+    for (int i = 0; i < 4; ++i, p += 4)
+        s.rng.s[i] = getU32(p);
+    s.randomizer = (Randomizer)p[0];
+    s.bagPos = p[1];
+    std::memcpy(s.bag, p + 2, 7);
+    s.gameOver = p[9] != 0;
+    p += 10;
+    s.score = (int)getU32(p);
+    s.lines = (int)getU32(p + 4);
+    s.pieces = (int)getU32(p + 8);
+    s.combo = (int)getU32(p + 12);
+    s.seed = getU64(p + 16);
+    s.ticks = getU32(p + 24);
+    s.gravityAcc = getU16(p + 28);
+    s.lockTicks = p[30];
+    s.level = levelForLines(s.lines);
+    s.lastClear = LineClearEvent{ 0, { -1, -1, -1, -1 }, 0 };
+    s.trackDirty = false;
+    clearDirty(s);
+    return true;
+}
+
+// Odtwarza grę i dopisuje klatkę co interval figur. Figura może pojawić się
+// w trakcie tików przed zdarzeniem – wtedy klatka wskazuje na to zdarzenie
+// jako następne do wykonania, tak samo jak zatrzymuje się seek.
+static uint32_t buildKeyframes(const Replay& r, int interval, std::vector<uint8_t>& out) {
+    GameState s;
+    beginReplay(s, r);
+    ReplayReader reader(r);
+    const uint8_t* base = r.data.data();
+
+    uint32_t count = 0;
+    int nextPiece = s.pieces + interval;   // pierwsza figura to stan startowy, bez klatki
+    auto keyframe = [&](uint32_t eventIndex, size_t dataOffset, uint32_t time) {
+        if (s.pieces < nextPiece)
+            return;
+        putU32(out, (uint32_t)s.pieces);
+        putU32(out, eventIndex);
+        putU32(out, (uint32_t)dataOffset);
+        putU32(out, time);
+        encodeSnapshot(s, out);
+        ++count;
+        nextPiece = s.pieces + interval;
+    };
+
+    ReplayEvent ev;
+    uint32_t n = 0;
+    while (n < r.eventCount) {
+        size_t offset = reader.offset(base);
+        uint32_t time = reader.time();
+        if (!reader.next(ev))
+            break;
+        if (r.version >= 2) {
+            while (s.ticks < ev.time && !s.gameOver) {
+                tick(s);
+                keyframe(n, offset, time);
+            }
+        }
+        applyAction(s, ev.action);
+        ++n;
+        keyframe(n, reader.offset(base), reader.time());
+    }
+    if (r.version >= 2) {
+        while (s.ticks < r.endTime && !s.gameOver) {
+            tick(s);
+            keyframe(n, reader.offset(base), reader.time());
+        }
+    }
+    return count;
+}
+
+bool writeArchive(const char* path, const std::vector<Replay>& replays, int keyframeInterval) {
+    if (keyframeInterval <= 0)
+        return false;
+    FILE* f = fopen(path, "wb");
+    if (!f)
+        return false;
+
+    std::vector<uint8_t> buf(ARCHIVE_HEADER_SIZE, 0);
+    bool ok = fwrite(buf.data(), 1, buf.size(), f) == buf.size();
+    uint64_t offset = ARCHIVE_HEADER_SIZE;
+
+    std::vector<uint8_t> index;
+    for (size_t i = 0; i < replays.size() && ok; ++i) {
+        const Replay& r = replays[i];
+        buf.clear();
+        serializeReplay(r, buf);
+        uint32_t replaySize = (uint32_t)buf.size();
+        uint32_t keyframes = buildKeyframes(r, keyframeInterval, buf);
+
+        putU64(index, offset);
+        putU32(index, replaySize);
+        putU64(index, offset + replaySize);
+        putU32(index, keyframes);
+        putU32(index, (uint32_t)r.score);
+        putU32(index, (uint32_t)r.lines);
+        putU32(index, (uint32_t)r.pieces);
+        putU32(index, r.eventCount);
+
+        ok = fwrite(buf.data(), 1, buf.size(), f) == buf.size();
+        offset += buf.size();
+    }
+
+    if (ok)
+        ok = fwrite(index.data(), 1, index.size(), f) == index.size();
+
+    buf.clear();
+    buf.insert(buf.end(), ARCHIVE_MAGIC, ARCHIVE_MAGIC + 4);
+    putU32(buf, ARCHIVE_VERSION);
+    putU32(buf, (uint32_t)replays.size());
+    putU32(buf, (uint32_t)keyframeInterval);
+    putU64(buf, offset);
+    if (ok)
+        ok = fseek(f, 0, SEEK_SET) == 0 && fwrite(buf.data(), 1, buf.size(), f) == buf.size();
+
+    return fclose(f) == 0 && ok;
+}
+
+// --- Odczyt ---
+
+bool ArchiveReader::open(const char* path) {
+    close();
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+        CloseHandle(file);
+        return false;
+    }
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    void* base = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    if (!base) {
+        if (mapping) CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+    m_file = file;
+    m_mapping = mapping;
+    m_base = (const uint8_t*)base;
+    m_size = (size_t)size.QuadPart;
+#else
+    int fd = ::open(path, O_RDONLY);
+    if (fd < 0)
+        return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+        ::close(fd);
+        return false;
+    }
+    void* base = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (base == MAP_FAILED) {
+        ::close(fd);
+        return false;
+    }
+    m_fd = fd;
+    m_base = (const uint8_t*)base;
+    m_size = (size_t)st.st_size;
+#endif
+
+    if (m_size < ARCHIVE_HEADER_SIZE || std::memcmp(m_base, ARCHIVE_MAGIC, 4) != 0 ||
+        getU32(m_base + 4) != ARCHIVE_VERSION) {
+        close();
+        return false;
+    }
+    m_count = getU32(m_base + 8);
+    m_interval = getU32(m_base + 12);
+    uint64_t indexOffset = getU64(m_base + 16);
+    if (indexOffset > m_size || (m_size - indexOffset) / ARCHIVE_ENTRY_SIZE < m_count) {
+        close();
+        return false;
+    }
+    m_index = m_base + indexOffset;
+    return true;
+}
+
+void ArchiveReader::close() {
+#ifdef _WIN32
+    if (m_base) UnmapViewOfFile(m_base);
+    if (m_mapping) CloseHandle((HANDLE)m_mapping);
+    if (m_file) CloseHandle((HANDLE)m_file);
+    m_file = nullptr;
+    m_mapping = nullptr;
+#else
+    if (m_base) munmap((void*)m_base, m_size);
+    if (m_fd >= 0) ::close(m_fd);
+    m_fd = -1;
+#endif
+    m_base = nullptr;
+    m_size = 0;
+    m_count = 0;
+    m_interval = 0;
+    m_index = nullptr;
+}
+
+ArchiveEntry ArchiveReader::entry(int index) const {
+    ArchiveEntry e = {};
+    if (index < 0 || index >= (int)m_count)
+        return e;   // pusty wpis: zero zdarzeń, zero klatek
+    const uint8_t* p = m_index + (size_t)index * ARCHIVE_ENTRY_SIZE;
+    e.replayOffset = getU64(p);
+    e.replaySize = getU32(p + 8);
+    e.keyframeOffset = getU64(p + 12);
+    e.keyframeCount = getU32(p + 20);
+    e.score = (int)getU32(p + 24);
+    e.lines = (int)getU32(p + 28);
+    e.pieces = (int)getU32(p + 32);
+    e.eventCount = getU32(p + 36);
+    return e;
+}
+
+bool ArchiveReader::replay(int index, ReplayView& v) const {
+    if (index < 0 || index >= (int)m_count)
+        return false;
+    ArchiveEntry e = entry(index);
+    if (e.replayOffset > m_size || e.replaySize > m_size - e.replayOffset)
+        return false;
+    return parseReplay(m_base + e.replayOffset, e.replaySize, v) != 0;
+}
+
+KeyframeView ArchiveReader::keyframe(const ArchiveEntry& e, int k) const {
+    if (k < 0 || (uint32_t)k >= e.keyframeCount || e.keyframeOffset > m_size ||
+        e.keyframeCount > (m_size - e.keyframeOffset) / KEYFRAME_SIZE)
+        return KeyframeView{ 0, 0, 0, 0, nullptr };   // snapshot == nullptr: brak klatki
+    const uint8_t* p = m_base + e.keyframeOffset + (size_t)k * KEYFRAME_SIZE;
+    return KeyframeView{ getU32(p), getU32(p + 4), getU32(p + 8), getU32(p + 12), p + 16 };
+}
+
+bool ArchiveReader::seek(int index, int piece, GameState& out) const {
+    ReplayView v;
+    if (!replay(index, v))
+        return false;
+    ArchiveEntry e = entry(index);
+    if (e.keyframeOffset > m_size || e.keyframeCount > (m_size - e.keyframeOffset) / KEYFRAME_SIZE)
+        return false;
+
+    // ostatnia klatka nie późniejsza niż szukana figura (klatki są rosnące)
+    int lo = 0, hi = (int)e.keyframeCount;
+    while (lo < hi) {
+        int mid = (lo + hi) / 2;
+        if ((int)keyframe(e, mid).piece <= piece)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    uint32_t eventIndex = 0;
+    ReplayReader reader(v);
+    if (lo > 0) {
+        KeyframeView kf = keyframe(e, lo - 1);
+        if (kf.dataOffset > v.size || !decodeSnapshot(kf.snapshot, out))
+            return false;
+        eventIndex = kf.eventIndex;
+        reader = ReplayReader(v.data + kf.dataOffset, v.size - kf.dataOffset, kf.time);
+    }
+    else {
+        beginReplay(out, v);
+    }
+
+    // tiki po kolei, bo figura może pojawić się też po zablokowaniu przez grawitację
+    ReplayEvent ev;
+    while (out.pieces < piece && eventIndex < v.eventCount && reader.next(ev)) {
+        if (v.version >= 2) {
+            while (out.ticks < ev.time && !out.gameOver && out.pieces < piece)
+                tick(out);
+            if (out.pieces >= piece)
+                break;
+        }
+        applyAction(out, ev.action);
+        ++eventIndex;
+    }
+    if (v.version >= 2) {
+        while (out.ticks < v.endTime && !out.gameOver && out.pieces < piece)
+            tick(out);
+    }
+    return out.pieces >= piece;
+}
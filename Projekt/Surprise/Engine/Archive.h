@@ -0,0 +1,91 @@
+﻿#pragma once
+
+// Archiwum wielu zapisów gier w jednym pliku, czytane przez mmap bez kopiowania.
+// Dla każdej gry co KEYFRAME_INTERVAL figur zapisujemy klatkę kluczową –
+// pełny stan gry w zwartej postaci – więc przewinięcie do dowolnej figury
+// startuje z najbliższej klatki zamiast symulować grę od początku.
+//
+// Układ pliku (little-endian):
+//   nagłówek:   "TARC", wersja u32, liczba gier u32, interwał klatek u32, offset indeksu u64
+//   dane gier:  zapis gry (serializeReplay), zaraz za nim jego klatki kluczowe
+//   indeks:     na grę: offset i rozmiar zapisu, offset i liczba klatek, wynik, linie, figury
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Replay.h"
+
+const int KEYFRAME_INTERVAL = 64;
+
+// Zwarty zapis stanu gry: maski wierszy, spakowane kolory, figura,
+// generator losowy, liczniki i stan grawitacji (wysokości kolumn i poziom
+// są liczone przy odczycie)
+const size_t SNAPSHOT_SIZE = BOARD_H * 2 + sizeof(Board::colors) + 4 + 16 + 9 + 1 + 16 + 8 + 4 + 2 + 1;
+
+void encodeSnapshot(const GameState& s, std::vector<uint8_t>& out);
+// false, gdy figura, worek lub sposób losowania są spoza zakresu (stan niezmieniony)
+bool decodeSnapshot(const uint8_t* p, GameState& s);
+
+// Klatka kluczowa w pliku
+struct KeyframeView {
+    uint32_t piece;       // wartość GameState::pieces w klatce
+    uint32_t eventIndex;  // ile zdarzeń zapisu już wykonano
+    uint32_t dataOffset;  // offset następnego zdarzenia w danych zapisu
+    uint32_t time;        // czas ostatniego wykonanego zdarzenia
+    const uint8_t* snapshot;
+};
+
+// Wpis indeksu – statystyki bez dekodowania zapisu
+struct ArchiveEntry {
+    uint64_t replayOffset;
+    uint32_t replaySize;
+    uint64_t keyframeOffset;
+    uint32_t keyframeCount;
+    int score;
+    int lines;
+    int pieces;
+    uint32_t eventCount;
+};
+
+// Buduje archiwum: każdą grę odtwarza, żeby wyliczyć klatki kluczowe
+bool writeArchive(const char* path, const std::vector<Replay>& replays,
+                  int keyframeInterval = KEYFRAME_INTERVAL);
+
+class ArchiveReader {
+public:
+    ArchiveReader() = default;
+    ~ArchiveReader() { close(); }
+
+    ArchiveReader(const ArchiveReader&) = delete;
+    ArchiveReader& operator=(const ArchiveReader&) = delete;
+
+    bool open(const char* path);
+    void close();
+
+    int replayCount() const { return (int)m_count; }
+    int keyframeInterval() const { return (int)m_interval; }
+
+    // Indeks spoza zakresu daje pusty wpis (same zera), a klatka spoza
+    // zakresu albo pliku – widok z snapshot == nullptr
+    ArchiveEntry entry(int index) const;
+    bool replay(int index, ReplayView& v) const;
+    KeyframeView keyframe(const ArchiveEntry& e, int k) const;
+
+    // Stan gry index w chwili, gdy figura nr piece (1..) właśnie się pojawiła.
+    // Startuje z najbliższej wcześniejszej klatki kluczowej.
+    bool seek(int index, int piece, GameState& out) const;
+
+private:
+    const uint8_t* m_base = nullptr;
+    size_t m_size = 0;
+    uint32_t m_count = 0;
+    uint32_t m_interval = 0;
+    const uint8_t* m_index = nullptr;
+#ifdef _WIN32
+    void* m_file = nullptr;
+    void* m_mapping = nullptr;
+#else
+    int m_fd = -1;
+#endif
+};
@@ -0,0 +1,253 @@
+﻿#include "BatchEval.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define HAVE_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+#if defined(HAVE_X86) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define HAVE_SSE2 1
+#endif
+
+// MSVC pozwala na intrynsyki AVX2 bez flag kompilatora, GCC/Clang
+// potrzebują atrybutu na funkcji
+#if defined(HAVE_X86) && defined(_MSC_VER)
+#define HAVE_AVX2 1
+#define TARGET_AVX2
+#elif defined(HAVE_X86) && (defined(__GNUC__) || defined(__clang__))
+#define HAVE_AVX2 1
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
+static_assert(BOARD_W <= 14, "wiersz ze ścianami (BOARD_W + 2 bity) musi mieścić się w 16 bitach");
+
+const uint16_t ROW_WALLS = (uint16_t)(1u | (1u << (BOARD_W + 1)));
+const uint16_t ROW_TRANSITION_MASK = (uint16_t)((1u << (BOARD_W + 1)) - 1);
+
+// --- Skalarnie: jedna plansza, ten sam przebieg co wersje SIMD ---
+
+static void evaluateOne(const uint16_t* rows, size_t stride, int i, const float* w, float* out) {
+    int seen = 0, holeCount = 0, transitions = 0;
+    int h[BOARD_W] = { 0 };
+    for (int y = 0; y < BOARD_H; ++y) {
+        int r = rows[y * stride + i];
+        holeCount += bitCount((uint16_t)(seen & ~r));
+        seen |= r;
+        int t = (r << 1) | ROW_WALLS;
+        transitions += bitCount((uint16_t)((t ^ (t >> 1)) & ROW_TRANSITION_MASK));
+        for (int x = 0; x < BOARD_W; ++x)
+            h[x] += (seen >> x) & 1;
+    }
+    int height = 0, bump = 0, wellDepth = 0;
+    for (int x = 0; x < BOARD_W; ++x) {
+        height += h[x];
+        if (x + 1 < BOARD_W)
+            bump += h[x] > h[x + 1] ? h[x] - h[x + 1] : h[x + 1] - h[x];
+        int left = x > 0 ? h[x - 1] : BOARD_H;
+        int right = x + 1 < BOARD_W ? h[x + 1] : BOARD_H;
+        int d = (left < right ? left : right) - h[x];
+        if (d > 0)
+            wellDepth += d;
+    }
+
+    // kolejność działań jak w evaluateBoard
+    float v = 0;
+    v += w[FEAT_HEIGHT] * (float)height;
+    v += w[FEAT_HOLES] * (float)holeCount;
+    v += w[FEAT_BUMPINESS] * (float)bump;
+    v += w[FEAT_WELLS] * (float)wellDepth;
+    v += w[FEAT_ROW_TRANSITIONS] * (float)transitions;
+    out[i] = v;
+}
+
+// --- SSE2: 8 plansz w 16-bitowych pasach ---
+
+#ifdef HAVE_SSE2
+static inline __m128i popcount16(__m128i v) {
+    v = _mm_sub_epi16(v, _mm_and_si128(_mm_srli_epi16(v, 1), _mm_set1_epi16(0x5555)));
+    v = _mm_add_epi16(_mm_and_si128(v, _mm_set1_epi16(0x3333)),
+                      _mm_and_si128(_mm_srli_epi16(v, 2), _mm_set1_epi16(0x3333)));
+    v = _mm_and_si128(_mm_add_epi16(v, _mm_srli_epi16(v, 4)), _mm_set1_epi16(0x0F0F));
+    return _mm_and_si128(_mm_add_epi16(v, _mm_srli_epi16(v, 8)), _mm_set1_epi16(0x001F));
+}
+
+// a*w dodane do v dla 8 cech całkowitych rozbitych na dwie czwórki float
+static inline void addFeature(__m128& lo, __m128& hi, __m128i f, float w) {
+    __m128 wv = _mm_set1_ps(w);
+    __m128i zero = _mm_setzero_si128();
+    lo = _mm_add_ps(lo, _mm_mul_ps(wv, _mm_cvtepi32_ps(_mm_unpacklo_epi16(f, zero))));
+    hi = _mm_add_ps(hi, _mm_mul_ps(wv, _mm_cvtepi32_ps(_mm_unpackhi_epi16(f, zero))));
+}
+
+static void evaluateSse2(const uint16_t* rows, size_t stride, int i, const float* w, float* out) {
+    const __m128i one = _mm_set1_epi16(1);
+    const __m128i walls = _mm_set1_epi16((short)ROW_WALLS);
+    const __m128i transitionMask = _mm_set1_epi16((short)ROW_TRANSITION_MASK);
+    __m128i seen = _mm_setzero_si128(), holeCount = seen, transitions = seen;
+    __m128i h[BOARD_W];
+    for (int x = 0; x < BOARD_W; ++x)
+        h[x] = _mm_setzero_si128();
+
+    for (int y = 0; y < BOARD_H; ++y) {
+        __m128i r = _mm_loadu_si128((const __m128i*)(rows + y * stride + i));
+        holeCount = _mm_add_epi16(holeCount, popcount16(_mm_andnot_si128(r, seen)));
+        seen = _mm_or_si128(seen, r);
+        __m128i t = _mm_or_si128(_mm_slli_epi16(r, 1), walls);
+        t = _mm_and_si128(_mm_xor_si128(t, _mm_srli_epi16(t, 1)), transitionMask);
+        transitions = _mm_add_epi16(transitions, popcount16(t));
+        for (int x = 0; x < BOARD_W; ++x)
+            h[x] = _mm_add_epi16(h[x], _mm_and_si128(_mm_srli_epi16(seen, x), one));
+    }
+
+    const __m128i wall = _mm_set1_epi16(BOARD_H);
+    __m128i height = _mm_setzero_si128(), bump = height, wellDepth = height;
+    for (int x = 0; x < BOARD_W; ++x) {
+        height = _mm_add_epi16(height, h[x]);
+        if (x + 1 < BOARD_W)
+            bump = _mm_add_epi16(bump, _mm_sub_epi16(_mm_max_epi16(h[x], h[x + 1]), _mm_min_epi16(h[x], h[x + 1])));
+        __m128i left = x > 0 ? h[x - 1] : wall;
+        __m128i right = x + 1 < BOARD_W ? h[x + 1] : wall;
+        __m128i d = _mm_sub_epi16(_mm_min_epi16(left, right), h[x]);
+        wellDepth = _mm_add_epi16(wellDepth, _mm_max_epi16(d, _mm_setzero_si128()));
+    }
+
+    __m128 lo = _mm_setzero_ps(), hi = _mm_setzero_ps();
+    addFeature(lo, hi, height, w[FEAT_HEIGHT]);
+    addFeature(lo, hi, holeCount, w[FEAT_HOLES]);
+    addFeature(lo, hi, bump, w[FEAT_BUMPINESS]);
+    addFeature(lo, hi, wellDepth, w[FEAT_WELLS]);
+    addFeature(lo, hi, transitions, w[FEAT_ROW_TRANSITIONS]);
+    _mm_storeu_ps(out + i, lo);
+    _mm_storeu_ps(out + i + 4, hi);
+}
+#endif
+
+// --- AVX2: 16 plansz ---
+
+#ifdef HAVE_AVX2
+TARGET_AVX2 static inline __m256i popcount16Avx2(__m256i v) {
+    v = _mm256_sub_epi16(v, _mm256_and_si256(_mm256_srli_epi16(v, 1), _mm256_set1_epi16(0x5555)));
+    v = _mm256_add_epi16(_mm256_and_si256(v, _mm256_set1_epi16(0x3333)),
+                         _mm256_and_si256(_mm256_srli_epi16(v, 2), _mm256_set1_epi16(0x3333)));
+    v = _mm256_and_si256(_mm256_add_epi16(v, _mm256_srli_epi16(v, 4)), _mm256_set1_epi16(0x0F0F));
+    return _mm256_and_si256(_mm256_add_epi16(v, _mm256_srli_epi16(v, 8)), _mm256_set1_epi16(0x001F));
+}
+
+TARGET_AVX2 static inline void addFeatureAvx2(__m256& lo, __m256& hi, __m256i f, float w) {
+    __m256 wv = _mm256_set1_ps(w);
+    lo = _mm256_add_ps(lo, _mm256_mul_ps(wv, _mm256_cvtepi32_ps(_mm256_cvtepu16_epi32(_mm256_castsi256_si128(f)))));
+    hi = _mm256_add_ps(hi, _mm256_mul_ps(wv, _mm256_cvtepi32_ps(_mm256_cvtepu16_epi32(_mm256_extracti128_si256(f, 1)))));
+}
+
+TARGET_AVX2 static void evaluateAvx2(const uint16_t* rows, size_t stride, int i, const float* w, float* out) {
+    const __m256i one = _mm256_set1_epi16(1);
+    const __m256i walls = _mm256_set1_epi16((short)ROW_WALLS);
+    const __m256i transitionMask = _mm256_set1_epi16((short)ROW_TRANSITION_MASK);
+    __m256i seen = _mm256_setzero_si256(), holeCount = seen, transitions = seen;
+    __m256i h[BOARD_W];
+    for (int x = 0; x < BOARD_W; ++x)
+        h[x] = _mm256_setzero_si256();
+
+    for (int y = 0; y < BOARD_H; ++y) {
+        __m256i r = _mm256_loadu_si256((const __m256i*)(rows + y * stride + i));
+        holeCount = _mm256_add_epi16(holeCount, popcount16Avx2(_mm256_andnot_si256(r, seen)));
+        seen = _mm256_or_si256(seen, r);
+        __m256i t = _mm256_or_si256(_mm256_slli_epi16(r, 1), walls);
+        t = _mm256_and_si256(_mm256_xor_si256(t, _mm256_srli_epi16(t, 1)), transitionMask);
+        transitions = _mm256_add_epi16(transitions, popcount16Avx2(t));
+        for (int x = 0; x < BOARD_W; ++x)
+            h[x] = _mm256_add_epi16(h[x], _mm256_and_si256(_mm256_srli_epi16(seen, x), one));
+    }
+
+    const __m256i wall = _mm256_set1_epi16(BOARD_H);
+    __m256i height = _mm256_setzero_si256(), bump = height, wellDepth = height;
+    for (int x = 0; x < BOARD_W; ++x) {
+        height = _mm256_add_epi16(height, h[x]);
+        if (x + 1 < BOARD_W)
+            bump = _mm256_add_epi16(bump, _mm256_abs_epi16(_mm256_sub_epi16(h[x], h[x + 1])));
+        __m256i left = x > 0 ? h[x - 1] : wall;
+        __m256i right = x + 1 < BOARD_W ? h[x + 1] : wall;
+        __m256i d = _mm256_sub_epi16(_mm256_min_epi16(left, right), h[x]);
+        wellDepth = _mm256_add_epi16(wellDepth, _mm256_max_epi16(d, _mm256_setzero_si256()));
+    }
+
+    __m256 lo = _mm256_setzero_ps(), hi = _mm256_setzero_ps();
+    addFeatureAvx2(lo, hi, height, w[FEAT_HEIGHT]);
+    addFeatureAvx2(lo, hi, holeCount, w[FEAT_HOLES]);
+    addFeatureAvx2(lo, hi, bump, w[FEAT_BUMPINESS]);
+    addFeatureAvx2(lo, hi, wellDepth, w[FEAT_WELLS]);
+    addFeatureAvx2(lo, hi, transitions, w[FEAT_ROW_TRANSITIONS]);
+    _mm256_storeu_ps(out + i, lo);
+    _mm256_storeu_ps(out + i + 8, hi);
+}
+#endif
+
+// --- Wybór jądra ---
+
+static bool cpuHasAvx2() {
+#if defined(HAVE_AVX2) && defined(_MSC_VER)
+    int r[4];
+    __cpuid(r, 0);
+    if (r[0] < 7)
+        return false;
+    __cpuid(r, 1);
+    bool osSavesYmm = ((r[2] >> 27) & 1) && (_xgetbv(0) & 6) == 6;   // OSXSAVE i stan AVX
+    __cpuidex(r, 7, 0);
+    return osSavesYmm && ((r[1] >> 5) & 1);
+#elif defined(HAVE_AVX2)
+    return __builtin_cpu_supports("avx2");
+#else
+    return false;
+#endif
+}
+
+static BatchKernel detectBatchKernel() {
+    if (cpuHasAvx2())
+        return BATCH_AVX2;
+#ifdef HAVE_SSE2
+    return BATCH_SSE2;
+#else
+    return BATCH_SCALAR;
+#endif
+}
+
+BatchKernel bestBatchKernel() {
+    static const BatchKernel best = detectBatchKernel();
+    return best;
+}
+
+const char* batchKernelName(BatchKernel kernel) {
+    switch (kernel) {
+        case BATCH_SCALAR: return "scalar";
+        case BATCH_SSE2:   return "sse2";
+        case BATCH_AVX2:   return "avx2";
+        default:           return batchKernelName(bestBatchKernel());
+    }
+}
+
+void evaluateBatch(const uint16_t* rows, size_t stride, int count, const EvalWeights& weights,
+                   float* out, BatchKernel kernel) {
+    BatchKernel best = bestBatchKernel();
+    if (kernel == BATCH_AUTO || kernel > best)
+        kernel = best;
+
+    const float* w = weights.w;
+    int i = 0;
+#ifdef HAVE_AVX2
+    if (kernel == BATCH_AVX2) {
+        for (; i + 16 <= count; i += 16)
+            evaluateAvx2(rows, stride, i, w, out);
+    }
+#endif
+#ifdef HAVE_SSE2
+    if (kernel >= BATCH_SSE2) {
+        for (; i + 8 <= count; i += 8)
+            evaluateSse2(rows, stride, i, w, out);
+    }
+#endif
+    for (; i < count; ++i)
+        evaluateOne(rows, stride, i, w, out);
+}
@@ -0,0 +1,33 @@
+﻿#pragma once
+
+// Ocena wielu plansz naraz (te same cechy i wagi co evaluateBoard).
+// Plansze podajemy jako maski wierszy w układzie struktury tablic:
+// rows[y * stride + i] to wiersz y planszy i, więc jeden wektor SIMD
+// niesie ten sam wiersz 16 (AVX2) albo 8 (SSE2) plansz, po 16 bitów na planszę.
+// Wysokości kolumn, dziury, przejścia w wierszach, nierówność i studnie
+// liczymy tylko z masek; wynik jest bit w bit taki sam jak
+// evaluateBoard(b, 0, weights) – linie zależą od drogi i dodaje je wołający.
+//
+// Wersje AVX2/SSE2 wybierane w czasie działania, reszta (albo inny
+// procesor) idzie ścieżką skalarną. Nic nie alokuje.
+
+#include <cstddef>
+#include <cstdint>
+
+#include "Bot.h"
+
+enum BatchKernel {
+    BATCH_AUTO,     // najlepsza dostępna
+    BATCH_SCALAR,
+    BATCH_SSE2,
+    BATCH_AVX2,
+};
+
+// Jądro, którego użyje BATCH_AUTO na tym procesorze
+BatchKernel bestBatchKernel();
+const char* batchKernelName(BatchKernel kernel);
+
+// out[i] = ocena planszy i (i = 0..count-1); stride >= count.
+// Niedostępne jądro zastępuje najlepsze dostępne.
+void evaluateBatch(const uint16_t* rows, size_t stride, int count, const EvalWeights& weights,
+                   float* out, BatchKernel kernel = BATCH_AUTO);
@@ -0,0 +1,187 @@
+﻿#pragma once
+
+// Plansza w postaci bitowej: każdy wiersz to maska zajętości uint16_t
+// (bit x = kolumna x), a kolory trzymamy osobno, po 4 bity na komórkę.
+// Kolizja i test pełnego wiersza to kilka operacji AND/porównań
+// zamiast sprawdzania komórka po komórce w tablicy int.
+// Dodatkowo plansza pamięta wysokość każdej kolumny ("skyline"),
+// aktualizowaną przyrostowo przy blokowaniu figur i kasowaniu linii.
+// Tak samo przyrostowo liczony jest 64-bitowy skrót Zobrista zajętości –
+// klucz tablicy transpozycji przy przeszukiwaniu (Bot).
+
+#include <cstdint>
+#include <cstring>
+
+const int BOARD_W = 10;
+const int BOARD_H = 20;
+
+const uint16_t FULL_ROW = (uint16_t)((1u << BOARD_W) - 1);   // 0x3FF
+
+struct Board {
+    uint16_t rows[BOARD_H];                 // maski zajętości
+    uint8_t colors[BOARD_H][BOARD_W / 2];   // kolory 0..7, dwa na bajt (do rysowania)
+    uint8_t heights[BOARD_W];               // wysokość kolumny: BOARD_H - najwyższy zajęty wiersz, 0 = pusta
+    uint64_t hash;                          // Zobrist: XOR kluczy zajętych komórek (kolory się nie liczą)
+};
+
+// --- Skrót Zobrista ---
+
+// Klucz komórki (x, y) to losowa liczba 64-bitowa (splitmix64 ze stałego
+// ziarna). Dla szybkości trzymamy gotowe XOR-y kluczy dla każdej 5-bitowej
+// połówki wiersza, więc skrót całego wiersza to dwa odczyty z tablicy.
+struct ZobristTables {
+    uint64_t cells[BOARD_H][BOARD_W];
+    uint64_t halves[BOARD_H][2][32];   // [wiersz][kolumny 0..4 / 5..9][maska połówki]
+};
+
+constexpr ZobristTables makeZobristTables() {
+    ZobristTables t = {};
+    uint64_t x = 0x5A0B1457ull;
+    for (int y = 0; y < BOARD_H; ++y) {
+        for (int c = 0; c < BOARD_W; ++c) {
+            uint64_t z = (x += 0x9E3779B97F4A7C15ull);
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+            t.cells[y][c] = z ^ (z >> 31);
+        }
+        for (int h = 0; h < 2; ++h) {
+            for (int m = 0; m < 32; ++m) {
+                uint64_t v = 0;
+                for (int i = 0; i < 5; ++i)
+                    if ((m >> i) & 1)
+                        v ^= t.cells[y][h * 5 + i];
+                t.halves[y][h][m] = v;
+            }
+        }
+    }
+    return t;
+}
+
+inline constexpr ZobristTables ZOBRIST = makeZobristTables();
+
+static_assert(BOARD_W == 10, "ZobristTables dzieli wiersz na dwie połówki po 5 kolumn");
+
+// XOR kluczy zajętych komórek wiersza y
+inline uint64_t rowHash(int y, uint16_t mask) {
+    return ZOBRIST.halves[y][0][mask & 31] ^ ZOBRIST.halves[y][1][(mask >> 5) & 31];
+}
+
+// Skrót liczony od zera – po wczytaniu masek wierszy z pliku
+inline void recomputeHash(Board& b) {
+    b.hash = 0;
+    for (int y = 0; y < BOARD_H; ++y)
+        b.hash ^= rowHash(y, b.rows[y]);
+}
+
+inline void clearBoard(Board& b) {
+    std::memset(&b, 0, sizeof(b));
+}
+
+inline bool isCellFilled(const Board& b, int x, int y) {
+    return (b.rows[y] >> x) & 1u;
+}
+
+// 0 - puste, 1..7 - kolor figury
+inline int cellColor(const Board& b, int x, int y) {
+    return (b.colors[y][x >> 1] >> ((x & 1) * 4)) & 0xF;
+}
+
+// Ustawia komórkę bez aktualizacji heights – po ręcznym budowaniu
+// planszy trzeba wywołać recomputeHeights(). Skrót aktualizuje od razu.
+inline void setCell(Board& b, int x, int y, int color) {
+    uint8_t& c = b.colors[y][x >> 1];
+    int shift = (x & 1) * 4;
+    c = (uint8_t)((c & ~(0xF << shift)) | ((color & 0xF) << shift));
+    uint16_t before = b.rows[y];
+    if (color != 0)
+        b.rows[y] |= (uint16_t)(1u << x);
+    else
+        b.rows[y] &= (uint16_t)~(1u << x);
+    if (b.rows[y] != before)
+        b.hash ^= ZOBRIST.cells[y][x];
+}
+
+// Wysokości kolumn liczone od zera z masek wierszy
+inline void recomputeHeights(Board& b) {
+    uint16_t seen = 0;
+    for (int x = 0; x < BOARD_W; ++x)
+        b.heights[x] = 0;
+    for (int y = 0; y < BOARD_H && seen != FULL_ROW; ++y) {
+        uint16_t fresh = (uint16_t)(b.rows[y] & ~seen);
+        for (int x = 0; x < BOARD_W; ++x) {
+            if ((fresh >> x) & 1u)
+                b.heights[x] = (uint8_t)(BOARD_H - y);
+        }
+        seen |= fresh;
+    }
+}
+
+// --- Cechy planszy z wysokości kolumn (bez skanowania planszy) ---
+
+inline int aggregateHeight(const Board& b) {
+    int sum = 0;
+    for (int x = 0; x < BOARD_W; ++x)
+        sum += b.heights[x];
+    return sum;
+}
+
+inline int maxHeight(const Board& b) {
+    int m = 0;
+    for (int x = 0; x < BOARD_W; ++x)
+        if (b.heights[x] > m) m = b.heights[x];
+    return m;
+}
+
+// suma różnic wysokości sąsiednich kolumn
+inline int bumpiness(const Board& b) {
+    int sum = 0;
+    for (int x = 0; x + 1 < BOARD_W; ++x) {
+        int d = b.heights[x] - b.heights[x + 1];
+        sum += d < 0 ? -d : d;
+    }
+    return sum;
+}
+
+// --- Cechy planszy z masek wierszy ---
+
+inline int bitCount(uint16_t v) {
+    int n = 0;
+    for (; v; v &= (uint16_t)(v - 1))
+        ++n;
+    return n;
+}
+
+// puste komórki, nad którymi w tej samej kolumnie coś leży
+inline int holes(const Board& b) {
+    uint16_t covered = 0;
+    int n = 0;
+    for (int y = 0; y < BOARD_H; ++y) {
+        n += bitCount((uint16_t)(covered & ~b.rows[y]));
+        covered |= b.rows[y];
+    }
+    return n;
+}
+
+// suma głębokości studni: o ile kolumna jest niższa od niższej z sąsiednich
+// (ściana liczy się jak pełna kolumna)
+inline int wells(const Board& b) {
+    int sum = 0;
+    for (int x = 0; x < BOARD_W; ++x) {
+        int left = x > 0 ? b.heights[x - 1] : BOARD_H;
+        int right = x + 1 < BOARD_W ? b.heights[x + 1] : BOARD_H;
+        int d = (left < right ? left : right) - b.heights[x];
+        if (d > 0)
+            sum += d;
+    }
+    return sum;
+}
+
+// przejścia pełne/puste w wierszach, ściany liczą się jak pełne komórki
+inline int rowTransitions(const Board& b) {
+    int n = 0;
+    for (int y = 0; y < BOARD_H; ++y) {
+        uint32_t row = ((uint32_t)b.rows[y] << 1) | 1u | (1u << (BOARD_W + 1));
+        n += bitCount((uint16_t)((row ^ (row >> 1)) & ((1u << (BOARD_W + 1)) - 1)));
+    }
+    return n;
+}
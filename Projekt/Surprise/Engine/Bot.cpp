@@ -0,0 +1,185 @@
+﻿#include "Bot.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "BatchEval.h"
+
+void computeFeatures(const Board& b, int lines, float out[FEAT_COUNT]) {
+    out[FEAT_LINES] = (float)lines;
+    out[FEAT_HEIGHT] = (float)aggregateHeight(b);
+    out[FEAT_HOLES] = (float)holes(b);
+    out[FEAT_BUMPINESS] = (float)bumpiness(b);
+    out[FEAT_WELLS] = (float)wells(b);
+    out[FEAT_ROW_TRANSITIONS] = (float)rowTransitions(b);
+}
+
+float evaluateBoard(const Board& b, int lines, const EvalWeights& weights) {
+    float f[FEAT_COUNT];
+    computeFeatures(b, lines, f);
+    float v = 0;
+    for (int i = 0; i < FEAT_COUNT; ++i)
+        v += weights.w[i] * f[i];
+    return v;
+}
+
+// Skrót wag do klucza tablicy transpozycji
+static uint64_t weightsKey(const EvalWeights& weights) {
+    uint64_t key = 0;
+    for (int i = 0; i < FEAT_COUNT; ++i) {
+        uint32_t bits;
+        std::memcpy(&bits, &weights.w[i], sizeof(bits));
+        uint64_t x = key ^ bits;
+        key = splitmix64(x);
+    }
+    return key;
+}
+
+Bot::Bot(const BotConfig& config) : m_config(config), m_weightsKey(weightsKey(config.weights)) {
+    m_config.depth = std::max(1, std::min(m_config.depth, MAX_DEPTH));
+    m_config.beamWidth = std::max(1, m_config.beamWidth);
+    resetBoard(m_scratch, 0);
+    m_beam.reserve(m_config.beamWidth);
+    m_next.reserve(m_config.beamWidth * 64);
+    m_misses.reserve(m_config.beamWidth * 64);
+    m_batchRows.reserve(BOARD_H * m_config.beamWidth * 64);
+    m_batchScores.reserve(m_config.beamWidth * 64);
+}
+
+// Dzieci węzła: każde położenie figury start na jego planszy. Oceny
+// dostają później, w evaluateNext(), wszystkie dzieci poziomu naraz.
+void Bot::expand(const Node& parent, const Piece& start, PlacementGenerator& gen, int root) {
+    int n = gen.generate(parent.board, start);
+    for (int i = 0; i < n; ++i) {
+        m_scratch.board = parent.board;
+        m_scratch.currentPiece = gen.placement(i);
+        lockPiece(m_scratch);
+        LineClearEvent ev = clearLines(m_scratch);
+
+        Node child;
+        child.board = m_scratch.board;
+        child.lines = parent.lines + ev.count;
+        child.root = root < 0 ? i : root;
+        child.value = 0;
+        m_next.push_back(child);
+        if (m_config.table)
+            m_config.table->prefetch(child.board.hash ^ m_weightsKey);
+    }
+}
+
+// Oceny plansz z m_next bez linii (te zależą od drogi): z tablicy
+// transpozycji, a brakujące – maski wierszy przepisane do układu
+// evaluateBatch i ocenione razem
+void Bot::evaluateNext() {
+    const EvalWeights& w = m_config.weights;
+    m_misses.clear();
+    for (size_t i = 0; i < m_next.size(); ++i) {
+        float value;
+        if (m_config.table && m_config.table->probe(m_next[i].board.hash ^ m_weightsKey, value)) {
+            m_next[i].value = value;
+            ++m_cacheHits;
+        } else {
+            m_misses.push_back((int)i);
+        }
+    }
+
+    size_t count = m_misses.size();
+    m_batchRows.resize(BOARD_H * count);
+    m_batchScores.resize(count);
+    for (size_t j = 0; j < count; ++j) {
+        const Board& b = m_next[m_misses[j]].board;
+        for (int y = 0; y < BOARD_H; ++y)
+            m_batchRows[y * count + j] = b.rows[y];
+    }
+    evaluateBatch(m_batchRows.data(), count, (int)count, w, m_batchScores.data());
+    m_evaluated += (int)count;
+
+    for (size_t j = 0; j < count; ++j) {
+        Node& child = m_next[m_misses[j]];
+        child.value = m_batchScores[j];
+        if (m_config.table)
+            m_config.table->store(child.board.hash ^ m_weightsKey, child.value);
+    }
+    for (Node& child : m_next)
+        child.value += w.w[FEAT_LINES] * child.lines;
+}
+
+// Zostawia po jednym węźle na planszę – najlepszym (przy remisie z
+// wcześniejszym położeniem korzenia), żeby powtórki nie zajmowały wiązki
+void Bot::removeDuplicates() {
+    size_t slots = 64;
+    while (slots < m_next.size() * 2)
+        slots *= 2;
+    m_seen.assign(slots, -1);
+
+    size_t kept = 0;
+    for (size_t i = 0; i < m_next.size(); ++i) {
+        const Node& node = m_next[i];
+        size_t slot = (size_t)node.board.hash & (slots - 1);
+        for (;; slot = (slot + 1) & (slots - 1)) {
+            int j = m_seen[slot];
+            if (j < 0) {
+                m_seen[slot] = (int)kept;
+                m_next[kept++] = node;
+                break;
+            }
+            Node& other = m_next[j];
+            if (other.board.hash == node.board.hash &&
+                !std::memcmp(other.board.rows, node.board.rows, sizeof(node.board.rows))) {
+                if (node.value > other.value || (node.value == other.value && node.root < other.root))
+                    other = node;
+                ++m_duplicates;
+                break;
+            }
+        }
+    }
+    m_next.resize(kept);
+}
+
+int Bot::think(const GameState& s, Action* out, int maxActions) {
+    m_evaluated = 0;
+    m_cacheHits = 0;
+    m_duplicates = 0;
+    if (s.gameOver)
+        return 0;
+
+    int shapes[MAX_DEPTH];
+    shapes[0] = s.currentPiece.shape;
+    peekShapes(s, shapes + 1, m_config.depth - 1);
+
+    m_next.clear();
+    expand(Node{ s.board, 0, -1, 0 }, s.currentPiece, m_rootGen, -1);
+    if (m_next.empty())
+        return 0;
+    evaluateNext();
+
+    int best = -1;
+    for (int d = 0;; ++d) {
+        // zostaje beamWidth najlepszych; przy remisie wygrywa wcześniejsze położenie
+        auto better = [](const Node& a, const Node& b) {
+            return a.value != b.value ? a.value > b.value : a.root < b.root;
+        };
+        removeDuplicates();
+        if ((int)m_next.size() > m_config.beamWidth) {
+            std::nth_element(m_next.begin(), m_next.begin() + m_config.beamWidth, m_next.end(), better);
+            m_next.resize(m_config.beamWidth);
+        }
+        m_beam.swap(m_next);
+        best = (int)(std::min_element(m_beam.begin(), m_beam.end(), better) - m_beam.begin());
+        if (d + 1 >= m_config.depth)
+            break;
+
+        m_next.clear();
+        Piece start = spawnPosition(shapes[d + 1]);
+        for (const Node& node : m_beam) {
+            if (!isCollision(node.board, start))
+                expand(node, start, m_gen, node.root);
+        }
+        // następna figura nigdzie się nie mieści – zostaje najlepszy z tego poziomu
+        if (m_next.empty())
+            break;
+        evaluateNext();
+    }
+
+    return m_rootGen.path(m_beam[best].root, out, maxActions);
+}
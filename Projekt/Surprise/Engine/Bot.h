@@ -0,0 +1,86 @@
+﻿#pragma once
+
+// Bot: ocenia położenia figur ważoną sumą cech planszy i szuka wiązką
+// (beam search) kilka figur w przód, korzystając z podglądu kolejnych figur.
+// Z najlepszego liścia bierze położenie bieżącej figury i drogę do niego.
+// Różne kolejności położeń często dają tę samą planszę: na każdym poziomie
+// zostaje jeden węzeł na planszę, a oceny plansz pamięta (opcjonalna,
+// wspólna dla wielu botów) tablica transpozycji. Brakujące oceny całego
+// poziomu liczy naraz evaluateBatch (SIMD).
+
+#include <vector>
+
+#include "Engine.h"
+#include "Placement.h"
+#include "Transposition.h"
+
+// Cechy planszy po zablokowaniu figury i skasowaniu linii
+enum EvalFeature {
+    FEAT_LINES,             // skasowane linie
+    FEAT_HEIGHT,            // suma wysokości kolumn
+    FEAT_HOLES,             // dziury pod stosem
+    FEAT_BUMPINESS,         // różnice wysokości sąsiednich kolumn
+    FEAT_WELLS,             // głębokość studni
+    FEAT_ROW_TRANSITIONS,   // przejścia pełne/puste w wierszach
+    FEAT_COUNT
+};
+
+struct EvalWeights {
+    float w[FEAT_COUNT] = { 0.76f, -0.51f, -0.36f, -0.18f, -0.1f, -0.1f };
+};
+
+void computeFeatures(const Board& b, int lines, float out[FEAT_COUNT]);
+float evaluateBoard(const Board& b, int lines, const EvalWeights& weights);
+
+struct BotConfig {
+    int depth = 3;          // ile figur (bieżąca + podgląd) przeszukać
+    int beamWidth = 32;     // ile najlepszych plansz zostaje na każdym poziomie
+    EvalWeights weights;
+    TranspositionTable* table = nullptr;   // pamięć ocen, może być wspólna dla wielu wątków
+};
+
+class Bot {
+public:
+    static constexpr int MAX_DEPTH = 8;
+
+    explicit Bot(const BotConfig& config = BotConfig());
+
+    const BotConfig& config() const { return m_config; }
+
+    // Droga bieżącej figury do najlepszego położenia (kończy ją ACT_HARD_DROP).
+    // Zwraca liczbę akcji; 0, gdy figura nie ma gdzie wylądować.
+    int think(const GameState& s, Action* out, int maxActions);
+
+    // Ile plansz oceniono w ostatnim think(), ile ocen wzięto z tablicy
+    // i ile powtórzonych plansz pominięto
+    int evaluated() const { return m_evaluated; }
+    int cacheHits() const { return m_cacheHits; }
+    int duplicates() const { return m_duplicates; }
+
+private:
+    struct Node {
+        Board board;
+        int lines;      // linie skasowane od korzenia
+        int root;       // numer położenia bieżącej figury, od którego wyszedł
+        float value;
+    };
+
+    void expand(const Node& parent, const Piece& start, PlacementGenerator& gen, int root);
+    void evaluateNext();
+    void removeDuplicates();
+
+    BotConfig m_config;
+    PlacementGenerator m_rootGen;   // położenia bieżącej figury – z nich bierzemy drogę
+    PlacementGenerator m_gen;
+    GameState m_scratch;            // lockPiece/clearLines na kopii planszy
+    std::vector<Node> m_beam;
+    std::vector<Node> m_next;
+    std::vector<int> m_misses;          // evaluateNext: węzły bez oceny w tablicy
+    std::vector<uint16_t> m_batchRows;  // ich maski wierszy dla evaluateBatch
+    std::vector<float> m_batchScores;
+    std::vector<int> m_seen;        // removeDuplicates: otwarte adresowanie po Board::hash
+    uint64_t m_weightsKey;          // wagi w kluczu tablicy – boty z różnymi wagami jej nie mylą
+    int m_evaluated = 0;
+    int m_cacheHits = 0;
+    int m_duplicates = 0;
+};
@@ -0,0 +1,36 @@
+﻿#include "Clock.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <chrono>
+#endif
+
+int64_t clockNowNs() {
+#ifdef _WIN32
+    static const int64_t freq = [] {
+        LARGE_INTEGER f;
+        QueryPerformanceFrequency(&f);
+        return (int64_t)f.QuadPart;
+    }();
+    LARGE_INTEGER now;
+    QueryPerformanceCounter(&now);
+    // bez przepełnienia: osobno pełne sekundy i reszta
+    int64_t t = (int64_t)now.QuadPart;
+    return t / freq * 1000000000LL + t % freq * 1000000000LL / freq;
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+int FixedStepClock::advance(int64_t nowNs, int maxSteps) {
+    m_accNs += nowNs - m_lastNs;
+    m_lastNs = nowNs;
+    int steps = (int)(m_accNs / m_stepNs);
+    m_accNs -= (int64_t)steps * m_stepNs;
+    if (steps > maxSteps)
+        steps = maxSteps;
+    return steps;
+}
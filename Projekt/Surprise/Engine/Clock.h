@@ -0,0 +1,33 @@
+﻿#pragma once
+
+// Zegar pętli gry: czas w nanosekundach z QueryPerformanceCounter (Windows)
+// albo std::chrono::steady_clock, i licznik stałych kroków logiki.
+
+#include <cstdint>
+
+int64_t clockNowNs();
+
+// Zamienia upływ czasu na liczbę tików do wykonania; rysowanie może
+// trwać dowolnie długo, a gra i tak idzie w krokach 1/ticksPerSecond.
+class FixedStepClock {
+public:
+    explicit FixedStepClock(int ticksPerSecond) : m_stepNs(1000000000LL / ticksPerSecond) {}
+
+    void reset(int64_t nowNs) {
+        m_lastNs = nowNs;
+        m_accNs = 0;
+    }
+
+    // Ile tików wypadło od poprzedniego wywołania. Po długiej przerwie
+    // (np. przeciąganie okna) nadrabia najwyżej maxSteps, reszta przepada.
+    int advance(int64_t nowNs, int maxSteps = 8);
+
+    // Za ile nanosekund wypada następny tik
+    int64_t nsUntilNextStep() const { return m_stepNs - m_accNs; }
+    int64_t stepNs() const { return m_stepNs; }
+
+private:
+    int64_t m_stepNs;
+    int64_t m_lastNs = 0;
+    int64_t m_accNs = 0;
+};
@@ -0,0 +1,366 @@
+﻿#include "Engine.h"
+
+#include <cstring>
+
+#include "Trace.h"
+
+bool isCollision(const Board& b, const Piece& p) {
+    const PieceMask& m = PIECE_TABLES.masks[p.shape][p.rot & 3];
+    if (p.x + m.minX < 0 || p.x + m.maxX >= BOARD_W ||
+        p.y + m.minY < 0 || p.y + m.maxY >= BOARD_H)
+        return true;
+    for (int r = m.minY; r <= m.maxY; ++r) {
+        uint16_t row = p.x >= 0 ? (uint16_t)(m.rows[r] << p.x) : (uint16_t)(m.rows[r] >> -p.x);
+        if (b.rows[p.y + r] & row)
+            return true;
+    }
+    return false;
+}
+
+// Kolejna figura 0..6 według wybranego sposobu losowania. Dostaje tylko
+// stan losowania, więc podgląd nie musi kopiować całego GameState.
+static int drawShape(Rng& rng, Randomizer randomizer, uint8_t* bag, int& bagPos) {
+    if (randomizer != RANDOMIZER_BAG7)
+        return (int)nextBelow(rng, 7);
+
+    if (bagPos >= 7) {
+        // nowy worek: tasowanie Fishera-Yatesa
+        for (int i = 0; i < 7; ++i)
+            bag[i] = (uint8_t)i;
+        for (int i = 6; i > 0; --i) {
+            int j = (int)nextBelow(rng, (uint32_t)i + 1);
+            uint8_t t = bag[i];
+            bag[i] = bag[j];
+            bag[j] = t;
+        }
+        bagPos = 0;
+    }
+    return bag[bagPos++];
+}
+
+int nextShape(GameState& s) {
+    return drawShape(s.rng, s.randomizer, s.bag, s.bagPos);
+}
+
+// Na kopii samego generatora i worka
+void peekShapes(const GameState& s, int* out, int n) {
+    Rng rng = s.rng;
+    uint8_t bag[7];
+    std::memcpy(bag, s.bag, sizeof(bag));
+    int bagPos = s.bagPos;
+    for (int i = 0; i < n; ++i)
+        out[i] = drawShape(rng, s.randomizer, bag, bagPos);
+}
+
+void resetBoard(GameState& s, uint64_t seed, Randomizer randomizer) {
+    clearBoard(s.board);
+    s.currentPiece = Piece{ 0, 0, 0, 0 };
+    s.gameOver = false;
+    s.score = 0;
+    s.lines = 0;
+    s.pieces = 0;
+    s.combo = 0;
+    s.lastClear = LineClearEvent{ 0, { -1, -1, -1, -1 }, 0 };
+    s.seed = seed;
+    seedRng(s.rng, seed);
+    s.randomizer = randomizer;
+    std::memset(s.bag, 0, sizeof(s.bag));
+    s.bagPos = 7;
+    s.level = 0;
+    s.ticks = 0;
+    s.gravityAcc = 0;
+    s.lockTicks = 0;
+    s.trackDirty = false;
+    clearDirty(s);
+}
+
+// --- Obszary do przerysowania ---
+
+void setDirtyTracking(GameState& s, bool enabled) {
+    s.trackDirty = enabled;
+    if (enabled)
+        markAllDirty(s);
+    else
+        clearDirty(s);
+}
+
+void markAllDirty(GameState& s) {
+    for (int y = 0; y < BOARD_H; ++y)
+        s.dirty.rows[y] = FULL_ROW;
+    s.dirty.hud = HUD_SCORE | HUD_STATUS;
+}
+
+void clearDirty(GameState& s) {
+    std::memset(&s.dirty, 0, sizeof(s.dirty));
+}
+
+bool isDirty(const GameState& s) {
+    if (s.dirty.hud)
+        return true;
+    for (int y = 0; y < BOARD_H; ++y)
+        if (s.dirty.rows[y])
+            return true;
+    return false;
+}
+
+static void markPiece(GameState& s, const Piece& p) {
+    const PieceMask& m = PIECE_TABLES.masks[p.shape][p.rot & 3];
+    for (int r = m.minY; r <= m.maxY; ++r) {
+        int y = p.y + r;
+        if (y < 0 || y >= BOARD_H)
+            continue;
+        uint16_t row = p.x >= 0 ? (uint16_t)(m.rows[r] << p.x) : (uint16_t)(m.rows[r] >> -p.x);
+        s.dirty.rows[y] |= (uint16_t)(row & FULL_ROW);
+    }
+}
+
+// Bieżąca figura i jej "duch" – wołane przed i po każdym ruchu
+static void markCurrentPiece(GameState& s) {
+    if (!s.trackDirty || s.gameOver)
+        return;
+    markPiece(s, s.currentPiece);
+    markPiece(s, ghostPiece(s));
+}
+
+void spawnNewPiece(GameState& s) {
+    TRACE_SCOPE("spawnNewPiece");
+    s.currentPiece = spawnPosition(nextShape(s));
+    ++s.pieces;
+    s.gravityAcc = 0;
+    s.lockTicks = 0;
+
+    if (isCollision(s, s.currentPiece)) {
+        s.gameOver = true;
+        if (s.trackDirty)
+            s.dirty.hud |= HUD_STATUS;
+    }
+    markCurrentPiece(s);
+}
+
+void lockPiece(GameState& s) {
+    Block blocks[4];
+    getPieceBlocks(s.currentPiece, blocks);
+    for (int i = 0; i < 4; ++i) {
+        int x = blocks[i].x;
+        int y = blocks[i].y;
+        if (y >= 0 && y < BOARD_H && x >= 0 && x < BOARD_W) {
+            setCell(s.board, x, y, s.currentPiece.shape + 1); // 1..7
+            if (BOARD_H - y > s.board.heights[x])
+                s.board.heights[x] = (uint8_t)(BOARD_H - y);
+        }
+    }
+    if (s.trackDirty)
+        markPiece(s, s.currentPiece);
+}
+
+// Kasuje wszystkie pełne wiersze w jednym przejściu: od najniższego pełnego
+// wiersza w górę przepisujemy niepełne wiersze na kolejne wolne miejsca.
+LineClearEvent clearLines(GameState& s) {
+    TRACE_SCOPE("clearLines");
+    Board& b = s.board;
+    LineClearEvent ev = { 0, { -1, -1, -1, -1 }, 0 };
+
+    int y = BOARD_H - 1;
+    while (y >= 0 && b.rows[y] != FULL_ROW)
+        --y;
+
+    uint32_t clearedRows = 0;   // bit y = wiersz y był pełny
+    int dst = y;
+    for (; y >= 0; --y) {
+        if (b.rows[y] == FULL_ROW) {
+            b.hash ^= rowHash(y, FULL_ROW);
+            clearedRows |= 1u << y;
+            if (ev.count < 4)
+                ev.rows[ev.count] = y;
+            ++ev.count;
+            continue;
+        }
+        if (dst != y) {
+            // wiersz zmienia numer: jego klucze z y zamieniamy na klucze z dst
+            b.hash ^= rowHash(y, b.rows[y]) ^ rowHash(dst, b.rows[y]);
+            b.rows[dst] = b.rows[y];
+            std::memcpy(b.colors[dst], b.colors[y], sizeof(b.colors[0]));
+        }
+        --dst;
+    }
+    for (; dst >= 0; --dst) {
+        b.rows[dst] = 0;
+        std::memset(b.colors[dst], 0, sizeof(b.colors[0]));
+    }
+
+    // Pełny wiersz ma zajęte wszystkie kolumny, więc leży nie wyżej niż
+    // szczyt każdej kolumny. Jeśli szczyt nie był skasowany, kolumna po prostu
+    // obniża się o liczbę linii; w przeciwnym razie szukamy nowego szczytu.
+    if (ev.count > 0) {
+        for (int x = 0; x < BOARD_W; ++x) {
+            int top = BOARD_H - b.heights[x];
+            if (!((clearedRows >> top) & 1u)) {
+                b.heights[x] = (uint8_t)(b.heights[x] - ev.count);
+                continue;
+            }
+            int yy = top;
+            while (yy < BOARD_H && !((b.rows[yy] >> x) & 1u))
+                ++yy;
+            b.heights[x] = (uint8_t)(BOARD_H - yy);
+        }
+    }
+
+    // wszystko nad najniższym skasowanym wierszem przesunęło się w dół
+    if (ev.count > 0 && s.trackDirty) {
+        for (int yy = 0; yy <= ev.rows[0]; ++yy)
+            s.dirty.rows[yy] = FULL_ROW;
+    }
+
+    s.combo = ev.count > 0 ? s.combo + 1 : 0;
+    ev.combo = s.combo;
+    s.lines += ev.count;
+    s.level = levelForLines(s.lines);
+    s.lastClear = ev;
+    return ev;
+}
+
+// prosty system punktów: 100 za linię
+int scoreForClear(const LineClearEvent& ev) {
+    return ev.count * 100;
+}
+
+// Zablokowanie figury, kasowanie linii, punkty i nowa figura
+static void lockAndSpawn(GameState& s) {
+    lockPiece(s);
+    LineClearEvent ev = clearLines(s);
+    int points = scoreForClear(ev);
+    s.score += points;
+    if (points != 0 && s.trackDirty)
+        s.dirty.hud |= HUD_SCORE;
+    spawnNewPiece(s);
+}
+
+int dropDistance(const Board& b, const Piece& p) {
+    const PieceMask& m = PIECE_TABLES.masks[p.shape][p.rot & 3];
+    int dist = BOARD_H;
+    for (int c = m.minX; c <= m.maxX; ++c) {
+        int bottom = p.y + m.colBottom[c];
+        int surface = BOARD_H - b.heights[p.x + c];   // pierwszy zajęty wiersz kolumny
+        if (bottom >= surface) {
+            // figura jest pod nawisem – wysokości nic nie mówią, szukamy wiersz po wierszu
+            Piece tmp = p;
+            int d = 0;
+            for (tmp.y = p.y + 1; !isCollision(b, tmp); ++tmp.y)
+                ++d;
+            return d;
+        }
+        if (surface - 1 - bottom < dist)
+            dist = surface - 1 - bottom;
+    }
+    return dist;
+}
+
+Piece ghostPiece(const GameState& s) {
+    Piece g = s.currentPiece;
+    g.y += dropDistance(s.board, g);
+    return g;
+}
+
+// --- Grawitacja ---
+
+// Sekundy na wiersz: 0.6, 0.473, 0.355, 0.262, 0.19, 0.135, 0.094, 0.064,
+// 0.043, 0.028, 0.018, 0.011, 0.007, potem 5G, 10G i 20G
+static const int32_t GRAVITY_TABLE[MAX_LEVEL + 1] = {
+    1820, 2309, 3077, 4169, 5749, 8091, 11620, 17067,
+    25402, 39010, 60681, 99297, 156038, 5 * GRAVITY_ONE, 10 * GRAVITY_ONE, 20 * GRAVITY_ONE
+};
+
+int levelForLines(int lines) {
+    int level = lines / LINES_PER_LEVEL;
+    return level < MAX_LEVEL ? level : MAX_LEVEL;
+}
+
+int32_t gravityForLevel(int level) {
+    return GRAVITY_TABLE[level < 0 ? 0 : level > MAX_LEVEL ? MAX_LEVEL : level];
+}
+
+// Spadek o wiele wierszy w jednym tiku to jedno dropDistance na
+// wysokościach kolumn, a nie pętla isCollision wiersz po wierszu.
+void tick(GameState& s) {
+    if (s.gameOver) return;
+    ++s.ticks;
+    s.gravityAcc += gravityForLevel(s.level);
+    int rows = s.gravityAcc >> 16;
+    s.gravityAcc &= GRAVITY_ONE - 1;
+
+    int dist = dropDistance(s.board, s.currentPiece);
+    if (dist == 0) {
+        if (++s.lockTicks >= LOCK_DELAY_TICKS)
+            lockAndSpawn(s);
+        return;
+    }
+    s.lockTicks = 0;
+    if (rows == 0)
+        return;
+    markCurrentPiece(s);
+    s.currentPiece.y += rows < dist ? rows : dist;
+    markCurrentPiece(s);
+}
+
+void runTicks(GameState& s, uint32_t until) {
+    while (s.ticks < until && !s.gameOver)
+        tick(s);
+}
+
+void movePiece(GameState& s, int dx, int dy) {
+    TRACE_SCOPE("movePiece");
+    if (s.gameOver) return;
+    Piece tmp = s.currentPiece;
+    tmp.x += dx;
+    tmp.y += dy;
+    if (!isCollision(s, tmp)) {
+        markCurrentPiece(s);
+        s.currentPiece = tmp;
+        markCurrentPiece(s);
+    }
+    else if (dy != 0) {
+        // kolizja przy ruchu w dół -> blokujemy, kasujemy linie, generujemy nową figurę
+        lockAndSpawn(s);
+    }
+}
+
+void rotatePiece(GameState& s) {
+    if (s.gameOver) return;
+    Piece tmp = s.currentPiece;
+    tmp.rot = (tmp.rot + 1) & 3;
+    if (!isCollision(s, tmp)) {
+        markCurrentPiece(s);
+        s.currentPiece = tmp;
+        markCurrentPiece(s);
+    }
+}
+
+// "Hard drop": zrzut na dół
+void hardDrop(GameState& s) {
+    if (s.gameOver) return;
+    markCurrentPiece(s);   // duch pokrywa miejsce lądowania
+    s.currentPiece.y += dropDistance(s.board, s.currentPiece);
+    lockAndSpawn(s);
+}
+
+// --- Sterowanie wsadowe ---
+
+void applyAction(GameState& s, Action a) {
+    switch (a) {
+        case ACT_LEFT:      movePiece(s, -1, 0); break;
+        case ACT_RIGHT:     movePiece(s, 1, 0);  break;
+        case ACT_DOWN:      movePiece(s, 0, 1);  break;
+        case ACT_ROTATE:    rotatePiece(s);      break;
+        case ACT_HARD_DROP: hardDrop(s);         break;
+        default:            break;
+    }
+}
+
+int step(GameState& s, const Action* actions, int n) {
+    int i = 0;
+    while (i < n && !s.gameOver) {
+        applyAction(s, actions[i]);
+        ++i;
+    }
+    return i;
+}
@@ -0,0 +1,133 @@
+﻿#pragma once
+
+// Silnik gry – reguły Tetrisa niezależne od WinAPI.
+// Cały stan jednej gry siedzi w GameState, więc w jednym procesie
+// może działać dowolnie wiele gier (okno, symulacje, boty).
+
+#include <cstdint>
+
+#include "Board.h"
+#include "Pieces.h"
+#include "Random.h"
+
+// Akcje gracza – to samo, co obsługuje WndProc, ale bez okna
+enum Action : uint8_t {
+    ACT_NONE = 0,
+    ACT_LEFT,       // VK_LEFT
+    ACT_RIGHT,      // VK_RIGHT
+    ACT_DOWN,       // VK_DOWN / tik zegara
+    ACT_ROTATE,     // VK_UP
+    ACT_HARD_DROP,  // VK_SPACE
+    ACT_COUNT
+};
+
+// Wynik kasowania linii po zablokowaniu figury – scoring, animacja
+// i statystyki korzystają z niego zamiast ponownie skanować planszę.
+struct LineClearEvent {
+    int count;      // 0..4
+    int rows[4];    // skasowane wiersze (indeksy sprzed przesunięcia), od dołu
+    int combo;      // ile kolejnych zablokowań z rzędu kasowało linie (0 = brak)
+};
+
+// --- Czas gry ---
+// Logika biegnie w stałych krokach (tikach), niezależnie od rysowania.
+const int TICKS_PER_SECOND = 60;
+// Grawitacja w wierszach na tik, stałoprzecinkowo 16.16 (GRAVITY_ONE = 1G)
+const int32_t GRAVITY_ONE = 1 << 16;
+const int MAX_LEVEL = 15;           // od tego poziomu 20G
+const int LINES_PER_LEVEL = 10;
+// Ile tików leżąca figura czeka na zablokowanie przez grawitację
+const int LOCK_DELAY_TICKS = 30;
+
+// Pola panelu bocznego, które zmieniły się od ostatniego rysowania
+enum HudField : uint8_t {
+    HUD_SCORE  = 1,     // punkty
+    HUD_STATUS = 2,     // koniec gry
+};
+
+// Co trzeba przerysować od ostatniego clearDirty: stara i nowa pozycja
+// figury (z "duchem"), skasowane i przesunięte wiersze, pola panelu.
+struct DirtyRegion {
+    uint16_t rows[BOARD_H];   // bit x w rows[y] = komórka (x, y)
+    uint8_t hud;              // HudField
+};
+
+// Sposób losowania kolejnych figur
+enum Randomizer : uint8_t {
+    RANDOMIZER_UNIFORM = 0,   // każda figura niezależnie, 1/7
+    RANDOMIZER_BAG7,          // "worek" z siedmioma figurami w losowej kolejności
+};
+
+// Pełny stan jednej gry
+struct GameState {
+    Board board;
+    Piece currentPiece;
+    bool gameOver;
+    int score;
+    int lines;      // suma skasowanych linii
+    int pieces;     // liczba wygenerowanych figur
+    int combo;      // bieżąca seria zablokowań z kasowaniem linii
+    LineClearEvent lastClear;   // wynik ostatniego zablokowania
+    uint64_t seed;  // ziarno, z którego gra została rozpoczęta
+    Rng rng;        // generator losowy tej gry
+    Randomizer randomizer;
+    uint8_t bag[7]; // bieżący worek (RANDOMIZER_BAG7)
+    int bagPos;     // ile figur z worka już wydano
+    int level;          // poziom – co LINES_PER_LEVEL linii
+    uint32_t ticks;     // liczba wykonanych tików
+    int32_t gravityAcc; // ułamek wiersza zebrany przez grawitację (16.16)
+    int lockTicks;      // od ilu tików figura leży na podłożu
+    bool trackDirty;    // czy zbierać DirtyRegion (tylko okno, symulacje nie)
+    DirtyRegion dirty;
+};
+
+// --- Reguły ---
+bool isCollision(const Board& b, const Piece& p);
+inline bool isCollision(const GameState& s, const Piece& p) { return isCollision(s.board, p); }
+
+void resetBoard(GameState& s, uint64_t seed, Randomizer randomizer = RANDOMIZER_UNIFORM);
+int nextShape(GameState& s);
+void spawnNewPiece(GameState& s);
+// Położenie startowe nowej figury
+inline Piece spawnPosition(int shape) { return Piece{ BOARD_W / 2 - 2, 0, shape, 0 }; }
+// Podgląd n kolejnych figur bez zmiany stanu (te same, które wyda spawnNewPiece);
+// kopiuje tylko generator losowy i worek, nie cały GameState
+void peekShapes(const GameState& s, int* out, int n);
+void lockPiece(GameState& s);
+LineClearEvent clearLines(GameState& s);
+int scoreForClear(const LineClearEvent& ev);
+
+// O ile wierszy figura może opaść (wysokości kolumn zamiast próbkowania
+// isCollision wiersz po wierszu). Figura nie może kolidować z planszą.
+int dropDistance(const Board& b, const Piece& p);
+// Figura w miejscu, w którym wylądowałaby po hard dropie (podgląd "ducha")
+Piece ghostPiece(const GameState& s);
+
+// --- Obszary do przerysowania ---
+// resetBoard wyłącza śledzenie; włączenie zaznacza całą planszę i panel.
+void setDirtyTracking(GameState& s, bool enabled);
+void markAllDirty(GameState& s);
+void clearDirty(GameState& s);
+bool isDirty(const GameState& s);
+
+// --- Grawitacja ---
+int levelForLines(int lines);
+// Wiersze na tik (16.16) – od 600 ms na wiersz na poziomie 0 do 20G
+int32_t gravityForLevel(int level);
+// Jeden krok logiki: grawitacja (także wiele wierszy naraz) i blokowanie
+// leżącej figury po LOCK_DELAY_TICKS
+void tick(GameState& s);
+// Tiki aż s.ticks == until albo do końca gry
+void runTicks(GameState& s, uint32_t until);
+
+void movePiece(GameState& s, int dx, int dy);
+void rotatePiece(GameState& s);
+void hardDrop(GameState& s);
+
+// --- Sterowanie wsadowe ---
+// Wykonuje jedną akcję gracza.
+void applyAction(GameState& s, Action a);
+
+// Wykonuje do n akcji po kolei; przerywa po końcu gry.
+// Zwraca liczbę faktycznie wykonanych akcji.
+int step(GameState& s, const Action* actions, int n);
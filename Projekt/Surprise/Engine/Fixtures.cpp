@@ -0,0 +1,63 @@
+﻿#include "Fixtures.h"
+
+#include <cstring>
+
+const char* const FIXTURE_NAMES[] = { "empty", "mid", "full", "clear0", "clear1", "clear2", "clear3", "clear4" };
+const int FIXTURE_COUNT = sizeof(FIXTURE_NAMES) / sizeof(FIXTURE_NAMES[0]);
+
+// Wiersze od y w dół zapełnione z jedną dziurą przesuwającą się po kolumnach
+static void fillWithHoles(Board& b, int y) {
+    for (; y < BOARD_H; ++y) {
+        for (int x = 0; x < BOARD_W; ++x) {
+            if (x != (y * 3) % BOARD_W)
+                setCell(b, x, y, 1 + (x + y) % 7);
+        }
+    }
+}
+
+bool makeFixture(const char* name, GameState& s) {
+    if (!strcmp(name, "empty")) {
+        resetBoard(s, 1);
+        spawnNewPiece(s);
+        return true;
+    }
+    if (!strcmp(name, "mid")) {
+        // gracz losowy jak w symulatorze, aż stos sięgnie połowy planszy
+        resetBoard(s, 7);
+        spawnNewPiece(s);
+        Rng player = s.rng;
+        rngJump(player);
+        while (!s.gameOver && maxHeight(s.board) < BOARD_H / 2) {
+            uint32_t r = nextU32(player);
+            for (int i = 0; i < (int)(r & 3); ++i)
+                rotatePiece(s);
+            int dx = (int)((r >> 8) % BOARD_W) - BOARD_W / 2;
+            for (int i = 0; i < (dx < 0 ? -dx : dx); ++i)
+                movePiece(s, dx < 0 ? -1 : 1, 0);
+            hardDrop(s);
+        }
+        return !s.gameOver;
+    }
+    if (!strcmp(name, "full")) {
+        resetBoard(s, 3);
+        spawnNewPiece(s);
+        fillWithHoles(s.board, 4);
+        recomputeHeights(s.board);
+        return true;
+    }
+    if (!strncmp(name, "clear", 5) && name[5] >= '0' && name[5] <= '4' && !name[6]) {
+        // n pełnych wierszy na środku stosu, nad nimi i pod nimi wiersze z dziurami
+        int n = name[5] - '0';
+        resetBoard(s, 5);
+        spawnNewPiece(s);
+        fillWithHoles(s.board, BOARD_H / 2);
+        for (int i = 0; i < n; ++i) {
+            int y = BOARD_H / 2 + 2 + 2 * i;
+            for (int x = 0; x < BOARD_W; ++x)
+                setCell(s.board, x, y, 1 + x % 7);
+        }
+        recomputeHeights(s.board);
+        return true;
+    }
+    return false;
+}
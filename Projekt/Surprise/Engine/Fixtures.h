@@ -0,0 +1,15 @@
+﻿#pragma once
+
+// Stałe stany testowe (ziarna ustalone), wspólne dla narzędzi:
+// wzorce obrazów w RenderTool i pomiary w Bench.
+//   empty   – nowa gra
+//   mid     – gracz losowy do połowy wysokości planszy
+//   full    – plansza zapełniona bez pełnych wierszy
+//   clear0..clear4 – pod figurą nad stosem leży 0..4 pełnych wierszy
+
+#include "Engine.h"
+
+extern const char* const FIXTURE_NAMES[];
+extern const int FIXTURE_COUNT;
+
+bool makeFixture(const char* name, GameState& s);
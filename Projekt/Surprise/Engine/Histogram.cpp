@@ -0,0 +1,67 @@
+﻿#include "Histogram.h"
+
+int LatencyHistogram::bucketOf(int64_t ns) {
+    if (ns < SUB_BUCKETS)
+        return ns < 0 ? 0 : (int)ns;
+    if (ns >= (int64_t)1 << MAX_BITS)
+        return BUCKETS - 1;
+    // najstarszy bit wyznacza potęgę dwójki, SUB_BITS kolejnych – część
+    int exp = 63;
+    while (!((uint64_t)ns >> exp))
+        --exp;
+    int sub = (int)(ns >> (exp - SUB_BITS)) & (SUB_BUCKETS - 1);
+    return (exp - SUB_BITS + 1) * SUB_BUCKETS + sub;
+}
+
+int64_t LatencyHistogram::bucketUpper(int bucket) {
+    if (bucket < SUB_BUCKETS)
+        return bucket;
+    int exp = bucket / SUB_BUCKETS + SUB_BITS - 1;
+    int sub = bucket % SUB_BUCKETS;
+    int64_t width = (int64_t)1 << (exp - SUB_BITS);
+    return ((int64_t)(SUB_BUCKETS + sub) << (exp - SUB_BITS)) + width - 1;
+}
+
+void LatencyHistogram::reset() {
+    for (auto& c : m_counts)
+        c.store(0, std::memory_order_relaxed);
+    m_max.store(0, std::memory_order_relaxed);
+}
+
+uint64_t LatencyHistogram::count() const {
+    uint64_t n = 0;
+    for (const auto& c : m_counts)
+        n += c.load(std::memory_order_relaxed);
+    return n;
+}
+
+int64_t LatencyHistogram::percentile(double p) const {
+    uint64_t total = count();
+    if (total == 0)
+        return 0;
+    uint64_t rank = (uint64_t)(p / 100.0 * (double)total + 0.5);
+    if (rank < 1)
+        rank = 1;
+    uint64_t seen = 0;
+    for (int i = 0; i < BUCKETS; ++i) {
+        seen += m_counts[i].load(std::memory_order_relaxed);
+        if (seen >= rank) {
+            int64_t upper = bucketUpper(i);
+            int64_t mx = max();
+            return upper < mx ? upper : mx;
+        }
+    }
+    return max();
+}
+
+void writeHistogram(FILE* f, const char* name, const LatencyHistogram& h) {
+    fprintf(f, "%s count %llu p50 %lld p90 %lld p99 %lld p999 %lld max %lld\n", name,
+            (unsigned long long)h.count(), (long long)h.percentile(50), (long long)h.percentile(90),
+            (long long)h.percentile(99), (long long)h.percentile(99.9), (long long)h.max());
+    for (int i = 0; i < LatencyHistogram::BUCKETS; ++i) {
+        uint64_t n = h.bucketCount(i);
+        if (n)
+            fprintf(f, "%s bucket %lld %llu\n", name, (long long)LatencyHistogram::bucketUpper(i),
+                    (unsigned long long)n);
+    }
+}
@@ -0,0 +1,50 @@
+﻿#pragma once
+
+// Histogram czasów w nanosekundach w stylu HDR: przedziały rosną
+// wykładniczo, a każda potęga dwójki jest dzielona na SUB_BUCKETS równych
+// części, więc błąd względny wartości to najwyżej 1/SUB_BUCKETS (~6%)
+// w całym zakresie od 1 ns do ~18 minut. Zapis to kilka operacji na bitach
+// i jedno zwiększenie licznika – można go wołać w każdej klatce.
+//
+// Pisze jeden wątek; odczyt (percentyle) z innego wątku jest bezpieczny,
+// ale może nie widzieć wartości zapisanych w tej samej chwili.
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+
+class LatencyHistogram {
+public:
+    static const int SUB_BITS = 4;
+    static const int SUB_BUCKETS = 1 << SUB_BITS;
+    static const int MAX_BITS = 40;   // 2^40 ns; dłuższe liczą się jako najdłuższe
+    static const int BUCKETS = (MAX_BITS - SUB_BITS + 1) * SUB_BUCKETS;
+
+    void record(int64_t ns) {
+        int i = bucketOf(ns);
+        m_counts[i].store(m_counts[i].load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        if (ns > m_max.load(std::memory_order_relaxed))
+            m_max.store(ns, std::memory_order_relaxed);
+    }
+
+    void reset();
+
+    uint64_t count() const;
+    int64_t max() const { return m_max.load(std::memory_order_relaxed); }
+    // Górna granica przedziału, w którym leży percentyl p (0..100)
+    int64_t percentile(double p) const;
+
+    // Przedziały i ich granice (do zrzutu do pliku)
+    static int bucketOf(int64_t ns);
+    static int64_t bucketUpper(int bucket);
+    uint64_t bucketCount(int bucket) const { return m_counts[bucket].load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<uint64_t> m_counts[BUCKETS] = {};
+    std::atomic<int64_t> m_max{ 0 };
+};
+
+// Wiersz podsumowania i niepuste przedziały w formacie tekstowym:
+//   name count N p50 .. p90 .. p99 .. p999 .. max ..   (ns)
+//   name bucket <górna granica> <liczba>
+void writeHistogram(FILE* f, const char* name, const LatencyHistogram& h);
@@ -0,0 +1,101 @@
+﻿#include "Input.h"
+
+void InputHandler::reset() {
+    for (int k = 0; k < KEY_COUNT; ++k)
+        m_held[k] = false;
+    m_shiftKey = -1;
+}
+
+int64_t InputHandler::nextRepeatNs() const {
+    int64_t next = -1;
+    if (m_shiftKey >= 0)
+        next = m_shiftNextNs;
+    if (m_held[KEY_SOFT_DROP] && (next < 0 || m_dropNextNs < next))
+        next = m_dropNextNs;
+    return next;
+}
+
+void InputHandler::emit(int64_t timeNs, Action a, InputAction* out, int& n, int maxActions) {
+    if (n < maxActions)
+        out[n++] = { timeNs, a };
+}
+
+void InputHandler::apply(const InputEvent& ev, InputAction* out, int& n, int maxActions) {
+    int k = ev.key;
+    if (k >= KEY_COUNT)
+        return;
+
+    if (!ev.down) {
+        m_held[k] = false;
+        if (k == m_shiftKey) {
+            // drugi kierunek wciąż trzymany przejmuje ruch, z nowym DAS
+            int other = k == KEY_LEFT ? KEY_RIGHT : KEY_LEFT;
+            m_shiftKey = m_held[other] ? other : -1;
+            m_shiftNextNs = ev.timeNs + m_config.dasNs;
+        }
+        return;
+    }
+
+    // powtórne naciśnięcie bez puszczenia to autopowtarzanie systemu
+    if (m_held[k])
+        return;
+    m_held[k] = true;
+
+    switch (k) {
+        case KEY_LEFT:
+        case KEY_RIGHT:
+        m_shiftKey = k;
+        m_shiftNextNs = ev.timeNs + m_config.dasNs;
+        emit(ev.timeNs, k == KEY_LEFT ? ACT_LEFT : ACT_RIGHT, out, n, maxActions);
+        break;
+        case KEY_SOFT_DROP:
+        m_dropNextNs = ev.timeNs + m_config.softDropNs;
+        emit(ev.timeNs, ACT_DOWN, out, n, maxActions);
+        break;
+        case KEY_ROTATE:
+        emit(ev.timeNs, ACT_ROTATE, out, n, maxActions);
+        break;
+        case KEY_HARD_DROP:
+        emit(ev.timeNs, ACT_HARD_DROP, out, n, maxActions);
+        break;
+        default:
+        break;
+    }
+}
+
+int InputHandler::poll(InputQueue& queue, int64_t nowNs, InputAction* out, int maxActions) {
+    // ARR = 0 przesuwa do ściany i sprawdza ponownie co tik – dopiero
+    // opadnięcie figury może otworzyć dalszą drogę
+    const int64_t tickNs = 1000000000LL / TICKS_PER_SECOND;
+    int n = 0;
+    while (n < maxActions) {
+        InputEvent ev = {};
+        bool hasEvent = queue.peek(ev) && ev.timeNs <= nowNs;
+        int64_t repeat = nextRepeatNs();
+        bool hasRepeat = repeat >= 0 && repeat <= nowNs;
+        if (!hasEvent && !hasRepeat)
+            break;
+
+        if (hasEvent && (!hasRepeat || ev.timeNs <= repeat)) {
+            queue.pop();
+            apply(ev, out, n, maxActions);
+        } else if (m_shiftKey >= 0 && m_shiftNextNs == repeat) {
+            Action a = m_shiftKey == KEY_LEFT ? ACT_LEFT : ACT_RIGHT;
+            if (m_config.arrNs > 0) {
+                emit(repeat, a, out, n, maxActions);
+                m_shiftNextNs += m_config.arrNs;
+            } else {
+                // seria musi zmieścić się w całości, inaczej czeka na następne wywołanie
+                if (n > 0 && maxActions - n < BOARD_W - 1)
+                    break;
+                for (int i = 1; i < BOARD_W; ++i)
+                    emit(repeat, a, out, n, maxActions);
+                m_shiftNextNs += tickNs;
+            }
+        } else {
+            emit(repeat, ACT_DOWN, out, n, maxActions);
+            m_dropNextNs += m_config.softDropNs > 0 ? m_config.softDropNs : tickNs;
+        }
+    }
+    return n;
+}
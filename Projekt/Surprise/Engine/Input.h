@@ -0,0 +1,70 @@
+﻿#pragma once
+
+// Warstwa wejścia: okno wkłada do kolejki naciśnięcia i puszczenia klawiszy
+// ze znacznikiem czasu (ns), a InputHandler zamienia je na akcje gry.
+// Powtarzanie ruchu (DAS – opóźnienie do pierwszego powtórzenia, ARR – odstęp
+// kolejnych) liczymy sami, więc nie zależy od ustawień klawiatury w systemie.
+
+#include <cstdint>
+
+#include "Engine.h"
+#include "SpscQueue.h"
+
+enum InputKey : uint8_t {
+    KEY_LEFT,
+    KEY_RIGHT,
+    KEY_SOFT_DROP,
+    KEY_ROTATE,
+    KEY_HARD_DROP,
+    KEY_COUNT
+};
+
+struct InputEvent {
+    int64_t timeNs;
+    InputKey key;
+    bool down;
+};
+
+// Akcja wygenerowana przez warstwę wejścia i chwila, w której wypadła
+struct InputAction {
+    int64_t timeNs;
+    Action action;
+};
+
+struct InputConfig {
+    int64_t dasNs = 167000000;       // od naciśnięcia do pierwszego powtórzenia
+    int64_t arrNs = 33000000;        // między powtórzeniami; 0 – od razu do ściany
+    int64_t softDropNs = 33000000;   // między krokami miękkiego opadania
+};
+
+// Okno (producent) -> wątek symulacji (konsument); pełna kolejka gubi
+// najnowsze zdarzenie
+typedef SpscQueue<InputEvent, 64> InputQueue;
+
+class InputHandler {
+public:
+    explicit InputHandler(const InputConfig& config = InputConfig()) : m_config(config) {}
+
+    void configure(const InputConfig& config) { m_config = config; }
+    const InputConfig& config() const { return m_config; }
+
+    // Puszcza wszystkie klawisze (np. po utracie fokusu okna)
+    void reset();
+
+    // Przetwarza zdarzenia z kolejki i powtórzenia do chwili nowNs
+    // w kolejności czasu; zwraca liczbę akcji zapisanych w out.
+    int poll(InputQueue& queue, int64_t nowNs, InputAction* out, int maxActions);
+
+    // Czas najbliższego powtórzenia albo -1, gdy żaden klawisz go nie czeka
+    int64_t nextRepeatNs() const;
+
+private:
+    void apply(const InputEvent& ev, InputAction* out, int& n, int maxActions);
+    void emit(int64_t timeNs, Action a, InputAction* out, int& n, int maxActions);
+
+    InputConfig m_config;
+    bool m_held[KEY_COUNT] = { false };
+    int m_shiftKey = -1;          // aktywny kierunek (ostatnio naciśnięty)
+    int64_t m_shiftNextNs = 0;
+    int64_t m_dropNextNs = 0;
+};
@@ -0,0 +1,107 @@
+﻿#pragma once
+
+// Figury i tablice obrotów liczone w czasie kompilacji z baseShapes.
+// Gorąca ścieżka (kolizje, blokowanie, rysowanie) tylko czyta z tablic,
+// bez arytmetyki obrotów w czasie gry.
+
+#include <cstdint>
+
+// --- Struktury gry ---
+struct Piece {
+    int x;       // pozycja w komórkach (kolumna)
+    int y;       // pozycja w komórkach (wiersz)
+    int shape;   // 0..6
+    int rot;     // 0..3
+};
+
+// współrzędne x,y klocka (w obrębie 4x4 albo na planszy)
+struct Block { int x, y; };
+
+// definicje klocków w orientacji bazowej (rot = 0) w układzie 4x4
+constexpr Block baseShapes[7][4] = {
+    // I
+    { {0,1}, {1,1}, {2,1}, {3,1} },
+    // J
+    { {0,0}, {0,1}, {1,1}, {2,1} },
+    // L
+    { {2,0}, {0,1}, {1,1}, {2,1} },
+    // O
+    { {1,0}, {2,0}, {1,1}, {2,1} },
+    // S
+    { {1,0}, {2,0}, {0,1}, {1,1} },
+    // T
+    { {1,0}, {0,1}, {1,1}, {2,1} },
+    // Z
+    { {0,0}, {1,0}, {1,1}, {2,1} }
+};
+
+// Maski figury w danym obrocie: wiersz r ramki 4x4 jako maska bitowa
+// (bit i = kolumna i ramki) oraz granice zajętej części ramki.
+struct PieceMask {
+    uint16_t rows[4];
+    int minX, maxX;
+    int minY, maxY;
+    int colBottom[4];   // najniższy zajęty wiersz w kolumnie ramki, -1 = pusta
+};
+
+// Obrót punktu w macierzy 4x4 (0..3)
+constexpr Block rotateBlock(const Block& b, int rot) {
+    Block r = b;
+    for (int i = 0; i < (rot & 3); ++i) {
+        int x = r.x;
+        int y = r.y;
+        // obrót 90° CW: (x, y) -> (3 - y, x)
+        r.x = 3 - y;
+        r.y = x;
+    }
+    return r;
+}
+
+struct PieceTables {
+    Block blocks[7][4][4];   // [figura][obrót][klocek] – przesunięcia w ramce 4x4
+    PieceMask masks[7][4];   // [figura][obrót]
+};
+
+constexpr PieceTables makePieceTables() {
+    PieceTables t = {};
+    for (int shape = 0; shape < 7; ++shape) {
+        for (int rot = 0; rot < 4; ++rot) {
+            PieceMask& m = t.masks[shape][rot];
+            m.minX = 3; m.maxX = 0;
+            m.minY = 3; m.maxY = 0;
+            for (int c = 0; c < 4; ++c)
+                m.colBottom[c] = -1;
+            for (int i = 0; i < 4; ++i) {
+                Block b = rotateBlock(baseShapes[shape][i], rot);
+                t.blocks[shape][rot][i] = b;
+                m.rows[b.y] = (uint16_t)(m.rows[b.y] | (1u << b.x));
+                if (b.x < m.minX) m.minX = b.x;
+                if (b.x > m.maxX) m.maxX = b.x;
+                if (b.y < m.minY) m.minY = b.y;
+                if (b.y > m.maxY) m.maxY = b.y;
+                if (b.y > m.colBottom[b.x]) m.colBottom[b.x] = b.y;
+            }
+        }
+    }
+    return t;
+}
+
+inline constexpr PieceTables PIECE_TABLES = makePieceTables();
+
+// kilka kontrolnych wartości – pilnują, że tablice zgadzają się z baseShapes
+static_assert(PIECE_TABLES.masks[0][0].rows[1] == 0xF, "I poziomo");
+static_assert(PIECE_TABLES.masks[0][1].minX == 2 && PIECE_TABLES.masks[0][1].maxY == 3, "I pionowo");
+static_assert(PIECE_TABLES.masks[5][0].colBottom[1] == 1 && PIECE_TABLES.masks[5][0].colBottom[3] == -1, "T");
+static_assert(PIECE_TABLES.masks[3][2].rows[2] == 0x6 && PIECE_TABLES.masks[3][2].rows[3] == 0x6, "O po obrocie");
+
+inline void getPieceBlocks(const Piece& p, Block out[4]) {
+    const Block* off = PIECE_TABLES.blocks[p.shape][p.rot & 3];
+    for (int i = 0; i < 4; ++i) {
+        out[i].x = p.x + off[i].x;
+        out[i].y = p.y + off[i].y;
+    }
+}
+
+inline const PieceMask& getPieceMask(int shape, int rot) {
+    return PIECE_TABLES.masks[shape][rot & 3];
+}
@@ -0,0 +1,246 @@
+﻿#include "Placement.h"
+
+#include <cstring>
+
+namespace {
+
+// Obrót rot figury zajmuje te same komórki co obrót rot0 przesunięty o (dx, dy);
+// rot0 to najmniejszy taki obrót
+struct Canonical {
+    int rot;
+    int dx;
+    int dy;
+};
+
+struct CanonicalTable {
+    Canonical c[7][4];
+};
+
+constexpr bool sameCells(int shape, int a, int b, int dx, int dy) {
+    // każdy klocek obrotu a ma odpowiednik w obrocie b przesuniętym o (dx, dy)
+    for (int i = 0; i < 4; ++i) {
+        const Block& ba = PIECE_TABLES.blocks[shape][a][i];
+        bool found = false;
+        for (int j = 0; j < 4; ++j) {
+            const Block& bb = PIECE_TABLES.blocks[shape][b][j];
+            if (bb.x + dx == ba.x && bb.y + dy == ba.y)
+                found = true;
+        }
+        if (!found)
+            return false;
+    }
+    return true;
+}
+
+constexpr CanonicalTable makeCanonicalTable() {
+    CanonicalTable t = {};
+    for (int shape = 0; shape < 7; ++shape) {
+        for (int rot = 0; rot < 4; ++rot) {
+            const PieceMask& m = PIECE_TABLES.masks[shape][rot];
+            t.c[shape][rot] = Canonical{ rot, 0, 0 };
+            for (int r0 = 0; r0 < rot; ++r0) {
+                const PieceMask& m0 = PIECE_TABLES.masks[shape][r0];
+                int dx = m.minX - m0.minX;
+                int dy = m.minY - m0.minY;
+                if (sameCells(shape, rot, r0, dx, dy)) {
+                    t.c[shape][rot] = Canonical{ r0, dx, dy };
+                    break;
+                }
+            }
+        }
+    }
+    return t;
+}
+
+constexpr CanonicalTable CANONICAL = makeCanonicalTable();
+
+static_assert(CANONICAL.c[3][1].rot == 0 && CANONICAL.c[3][3].rot == 0, "O - jeden obrot");
+static_assert(CANONICAL.c[0][2].rot == 0 && CANONICAL.c[0][3].rot == 1, "I - dwa obroty");
+static_assert(CANONICAL.c[5][2].rot == 2, "T - cztery obroty");
+
+inline bool testBit(const uint64_t* bits, int i) { return (bits[i >> 6] >> (i & 63)) & 1; }
+inline void setBit(uint64_t* bits, int i) { bits[i >> 6] |= (uint64_t)1 << (i & 63); }
+
+// Ustawia bity [from, from + count), count <= 64
+inline void setBits(uint64_t* bits, int from, int count) {
+    uint64_t mask = count == 64 ? ~(uint64_t)0 : (((uint64_t)1 << count) - 1);
+    int shift = from & 63;
+    bits[from >> 6] |= mask << shift;
+    if (shift + count > 64)
+        bits[(from >> 6) + 1] |= mask >> (64 - shift);
+}
+
+} // namespace
+
+int PlacementGenerator::push(int x, int y, int rot, int parent, uint8_t action) {
+    m_x[m_tail] = (int8_t)x;
+    m_y[m_tail] = (int8_t)y;
+    m_rot[m_tail] = (uint8_t)rot;
+    m_action[m_tail] = action;
+    m_parent[m_tail] = (uint16_t)parent;
+    return m_tail++;
+}
+
+bool PlacementGenerator::visit(const Board& b, int x, int y, int rot, int parent, Action a) {
+    int n = nodeIndex(x, y, rot);
+    if (testBit(m_visited, n))
+        return false;
+    setBit(m_visited, n);
+    if (isCollision(b, Piece{ x, y, m_shape, rot }))
+        return false;
+    push(x, y, rot, parent, a);
+    return true;
+}
+
+// Położenie końcowe; te same komórki z innego obrotu już mogły się pojawić
+void PlacementGenerator::land(int node, int x, int y, int rot) {
+    const Canonical& c = CANONICAL.c[m_shape][rot];
+    int key = nodeIndex(x + c.dx, y + c.dy, c.rot);
+    if (!testBit(m_landed, key)) {
+        setBit(m_landed, key);
+        m_finals[m_count++] = (uint16_t)node;
+    }
+}
+
+// Stany nieba (figura w całości nad stosem, y >= start.y) zaznacza jako
+// odwiedzone i do kolejki wkłada tylko wyjścia z nieba: krok w dół z
+// najniższego wiersza nieba i obrót, po którym figura sięga stosu.
+// Zwraca false, gdy start nie leży w niebie w każdym obrocie – wtedy
+// zostaje zwykły BFS od startu.
+bool PlacementGenerator::seedFromSky(const Board& b, const Piece& start) {
+    int top = BOARD_H;   // najwyższy zajęty wiersz
+    for (int y = 0; y < BOARD_H; ++y) {
+        if (b.rows[y]) {
+            top = y;
+            break;
+        }
+    }
+
+    int skyY[4];
+    for (int rot = 0; rot < 4; ++rot) {
+        const PieceMask& m = PIECE_TABLES.masks[m_shape][rot];
+        skyY[rot] = top - 1 - m.maxY;
+        if (start.y > skyY[rot] || isCollision(b, Piece{ start.x, start.y, m_shape, rot }))
+            return false;
+    }
+
+    for (int rot = 0; rot < 4; ++rot) {
+        const PieceMask& m = PIECE_TABLES.masks[m_shape][rot];
+        for (int y = start.y; y <= skyY[rot]; ++y) {
+            setBits(m_visited, nodeIndex(-m.minX, y, rot), BOARD_W - m.maxX + m.minX);
+        }
+    }
+
+    for (int rot = 0; rot < 4; ++rot) {
+        const PieceMask& m = PIECE_TABLES.masks[m_shape][rot];
+        int next = (rot + 1) & 3;
+        // obrót wychodzi z nieba dla y > skyY[next]
+        int yFrom = skyY[next] + 1 > start.y ? skyY[next] + 1 : start.y;
+        for (int x = -m.minX; x < BOARD_W - m.maxX; ++x) {
+            for (int y = yFrom; y <= skyY[rot]; ++y) {
+                int n = nodeIndex(x, y, next);
+                if (testBit(m_visited, n) || isCollision(b, Piece{ x, y, m_shape, next })) {
+                    setBit(m_visited, n);
+                    continue;
+                }
+                setBit(m_visited, n);
+                int root = push(x, y, rot, NO_PARENT, ACT_SKY);
+                push(x, y, next, root, ACT_ROTATE);
+            }
+            // najniższy wiersz nieba: w dół albo lądowanie
+            int y = skyY[rot];
+            if (isCollision(b, Piece{ x, y + 1, m_shape, rot })) {
+                land(push(x, y, rot, NO_PARENT, ACT_SKY), x, y, rot);
+            }
+            else {
+                int n = nodeIndex(x, y + 1, rot);
+                if (!testBit(m_visited, n)) {
+                    setBit(m_visited, n);
+                    int root = push(x, y, rot, NO_PARENT, ACT_SKY);
+                    push(x, y + 1, rot, root, ACT_DOWN);
+                }
+            }
+        }
+    }
+    return true;
+}
+
+int PlacementGenerator::generate(const Board& b, const Piece& start) {
+    std::memset(m_visited, 0, sizeof(m_visited));
+    std::memset(m_landed, 0, sizeof(m_landed));
+    m_start = start;
+    m_start.rot &= 3;
+    m_shape = start.shape;
+    m_count = 0;
+    m_tail = 0;
+    if (isCollision(b, m_start))
+        return 0;
+    if (!seedFromSky(b, m_start)) {
+        std::memset(m_visited, 0, sizeof(m_visited));
+        m_tail = 0;
+        visit(b, m_start.x, m_start.y, m_start.rot, NO_PARENT, ACT_NONE);
+    }
+
+    for (int head = 0; head < m_tail; ++head) {
+        if (m_action[head] == ACT_SKY)
+            continue;
+        int x = m_x[head];
+        int y = m_y[head];
+        int rot = m_rot[head];
+
+        if (isCollision(b, Piece{ x, y + 1, m_shape, rot }))
+            land(head, x, y, rot);
+        else if (!testBit(m_visited, nodeIndex(x, y + 1, rot))) {
+            // wolne pole pod spodem – bez drugiego sprawdzania kolizji
+            setBit(m_visited, nodeIndex(x, y + 1, rot));
+            push(x, y + 1, rot, head, ACT_DOWN);
+        }
+        visit(b, x - 1, y, rot, head, ACT_LEFT);
+        visit(b, x + 1, y, rot, head, ACT_RIGHT);
+        visit(b, x, y, (rot + 1) & 3, head, ACT_ROTATE);
+    }
+    return m_count;
+}
+
+Piece PlacementGenerator::placement(int i) const {
+    int n = m_finals[i];
+    return Piece{ m_x[n], m_y[n], m_shape, m_rot[n] };
+}
+
+int PlacementGenerator::path(int i, Action* out, int maxActions) const {
+    // ruchy BFS od położenia końcowego wstecz do korzenia
+    Action reversed[NODES];
+    int bfs = 0;
+    int n = m_finals[i];
+    while (m_parent[n] != NO_PARENT) {
+        reversed[bfs++] = (Action)m_action[n];
+        n = m_parent[n];
+    }
+
+    // korzeń: obroty, przesunięcie i opadanie wprost ze startu
+    int rotations = (m_rot[n] - m_start.rot) & 3;
+    int dx = m_x[n] - m_start.x;
+    int downs = m_y[n] - m_start.y;
+    int len = rotations + (dx < 0 ? -dx : dx) + downs + bfs;
+
+    // ruchy w dół na końcu drogi zastępuje hard drop
+    int keep = len;
+    for (int k = 0; k < bfs && reversed[k] == ACT_DOWN; ++k)
+        --keep;
+    if (keep == rotations + (dx < 0 ? -dx : dx) + downs)
+        keep -= downs;
+    if (keep + 1 > maxActions)
+        return 0;
+
+    int k = 0;
+    for (int r = 0; r < rotations && k < keep; ++r)
+        out[k++] = ACT_ROTATE;
+    for (int r = 0; r < (dx < 0 ? -dx : dx) && k < keep; ++r)
+        out[k++] = dx < 0 ? ACT_LEFT : ACT_RIGHT;
+    for (int r = 0; r < downs && k < keep; ++r)
+        out[k++] = ACT_DOWN;
+    for (int r = bfs - 1; r >= 0 && k < keep; --r)
+        out[k++] = reversed[r];
+    out[k++] = ACT_HARD_DROP;
+    return k;
+}
@@ -0,0 +1,58 @@
+﻿#pragma once
+
+// Generator położeń końcowych: dla planszy i figury w położeniu startowym
+// znajduje wszystkie różne miejsca, w których figura może wylądować, razem
+// z akcjami, które ją tam doprowadzą. BFS po stanach (x, y, obrót) z ruchami
+// gracza (lewo, prawo, w dół, obrót), więc znajduje też wsunięcia pod nawis
+// i obroty w ostatniej chwili. Położenia o tych samych zajętych komórkach
+// (O w każdym obrocie, I/S/Z co pół obrotu) liczą się raz.
+//
+// Nad najwyższym zajętym wierszem ("niebo") każde położenie jest osiągalne
+// prosto ze startu (obrót, przesunięcie, opadanie), więc BFS zaczyna się
+// dopiero od stanów, w których figura wchodzi w stos.
+
+#include <cstdint>
+
+#include "Engine.h"
+
+class PlacementGenerator {
+public:
+    // Zwraca liczbę położeń; 0, gdy figura koliduje już na starcie
+    int generate(const Board& b, const Piece& start);
+
+    int count() const { return m_count; }
+    // Położenie końcowe nr i (figura nie może już opaść niżej)
+    Piece placement(int i) const;
+    // Najkrótsza droga do położenia i od startu; kończy ją ACT_HARD_DROP
+    // zamiast ciągu ruchów w dół. Zwraca długość (0, gdy nie mieści się w out).
+    int path(int i, Action* out, int maxActions) const;
+
+private:
+    static const int GRID_X = BOARD_W + 3;   // x od -3
+    static const int GRID_Y = BOARD_H + 3;   // y od -3
+    static const int NODES = 4 * GRID_X * GRID_Y;
+    static const int WORDS = (NODES + 63) / 64;
+
+    static const uint16_t NO_PARENT = 0xFFFF;
+    static const uint8_t ACT_SKY = ACT_COUNT;   // węzeł z nieba: droga wprost ze startu
+
+    static int nodeIndex(int x, int y, int rot) { return (rot * GRID_Y + y + 3) * GRID_X + x + 3; }
+    int push(int x, int y, int rot, int parent, uint8_t action);
+    bool visit(const Board& b, int x, int y, int rot, int parent, Action a);
+    void land(int node, int x, int y, int rot);
+    bool seedFromSky(const Board& b, const Piece& start);
+
+    Piece m_start = {};
+    int m_shape = 0;
+    int m_count = 0;
+    int m_tail = 0;
+    uint64_t m_visited[WORDS];
+    uint64_t m_landed[WORDS];
+    // kolejka BFS; indeksy kolejki służą też do odtwarzania drogi
+    int8_t m_x[NODES];
+    int8_t m_y[NODES];
+    uint8_t m_rot[NODES];
+    uint8_t m_action[NODES];
+    uint16_t m_parent[NODES];
+    uint16_t m_finals[NODES];    // pozycje w kolejce położeń końcowych
+};
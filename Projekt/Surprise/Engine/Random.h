@@ -0,0 +1,96 @@
+﻿#pragma once
+
+// Szybki generator liczb losowych ze stanem w obiekcie (xoshiro128**),
+// inicjowany przez splitmix64. Każda gra ma własny strumień, więc równoległe
+// symulacje nie dzielą stanu ani blokad, a gra jest odtwarzalna z ziarna.
+
+#include <cstdint>
+
+struct Rng {
+    uint32_t s[4];
+};
+
+inline uint64_t splitmix64(uint64_t& x) {
+    uint64_t z = (x += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+// Ziarno podstrumienia nr stream wyprowadzone z ziarna bazowego,
+// np. osobne ziarno dla każdej gry symulacji niezależnie od kolejności.
+inline uint64_t deriveSeed(uint64_t base, uint64_t stream) {
+    uint64_t x = base ^ (stream * 0xD1B54A32D192ED03ull);
+    return splitmix64(x);
+}
+
+inline void seedRng(Rng& r, uint64_t seed) {
+    uint64_t x = seed;
+    uint64_t a = splitmix64(x);
+    uint64_t b = splitmix64(x);
+    r.s[0] = (uint32_t)a;
+    r.s[1] = (uint32_t)(a >> 32);
+    r.s[2] = (uint32_t)b;
+    r.s[3] = (uint32_t)(b >> 32);
+    if ((r.s[0] | r.s[1] | r.s[2] | r.s[3]) == 0)
+        r.s[0] = 1;   // stan zerowy jest zabroniony
+}
+
+inline uint32_t rotl32(uint32_t x, int k) {
+    return (x << k) | (x >> (32 - k));
+}
+
+inline uint32_t nextU32(Rng& r) {
+    uint32_t* s = r.s;
+    uint32_t result = rotl32(s[1] * 5, 7) * 9;
+    uint32_t t = s[1] << 9;
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = rotl32(s[3], 11);
+    return result;
+}
+
+// Liczba z przedziału [0, n) bez przesunięcia rozkładu (metoda Lemire'a)
+inline uint32_t nextBelow(Rng& r, uint32_t n) {
+    uint64_t m = (uint64_t)nextU32(r) * n;
+    uint32_t low = (uint32_t)m;
+    if (low < n) {
+        uint32_t threshold = (0u - n) % n;
+        while (low < threshold) {
+            m = (uint64_t)nextU32(r) * n;
+            low = (uint32_t)m;
+        }
+    }
+    return (uint32_t)(m >> 32);
+}
+
+// Przeskok o 2^64 wywołań – kolejne przeskoki dają nienachodzące strumienie
+inline void rngJump(Rng& r) {
+    static const uint32_t JUMP[] = { 0x8764000b, 0xf542d2d3, 0x6fa035c3, 0x77f2db5b };
+    uint32_t s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+    for (int i = 0; i < 4; ++i) {
+        for (int b = 0; b < 32; ++b) {
+            if (JUMP[i] & (1u << b)) {
+                s0 ^= r.s[0];
+                s1 ^= r.s[1];
+                s2 ^= r.s[2];
+                s3 ^= r.s[3];
+            }
+            nextU32(r);
+        }
+    }
+    r.s[0] = s0;
+    r.s[1] = s1;
+    r.s[2] = s2;
+    r.s[3] = s3;
+}
+
+// Oddziela nowy strumień: zwraca bieżący stan, a rodzica przesuwa o 2^64
+inline Rng splitRng(Rng& parent) {
+    Rng child = parent;
+    rngJump(parent);
+    return child;
+}
@@ -0,0 +1,163 @@
+﻿#include "Replay.h"
+
+#include <cstdio>
+#include <cstring>
+
+#include "ByteIO.h"
+
+// nagłówek pliku: "TRPL", wersja; od wersji 2 na końcu tik końca gry
+static const uint8_t REPLAY_MAGIC[4] = { 'T', 'R', 'P', 'L' };
+static const size_t REPLAY_HEADER_SIZE_V1 = 4 + 1 + 1 + 2 + 8 + 4 * 3 + 4 + 4;
+static const size_t REPLAY_HEADER_SIZE = REPLAY_HEADER_SIZE_V1 + 4;
+
+ReplayView Replay::view() const {
+    return ReplayView{ version, seed, randomizer, score, lines, pieces, eventCount, endTime,
+                       data.data(), data.size() };
+}
+
+// --- Nagrywanie ---
+
+void ReplayRecorder::begin(uint64_t seed, Randomizer randomizer) {
+    m_replay = Replay();
+    m_replay.seed = seed;
+    m_replay.randomizer = randomizer;
+    m_lastTime = 0;
+}
+
+void ReplayRecorder::record(uint32_t time, Action action) {
+    uint32_t dt = time >= m_lastTime ? time - m_lastTime : 0;
+    m_lastTime += dt;
+    putVarint(m_replay.data, (dt << 3) | (action & 7));
+    ++m_replay.eventCount;
+}
+
+void ReplayRecorder::finish(const GameState& s) {
+    m_replay.score = s.score;
+    m_replay.lines = s.lines;
+    m_replay.pieces = s.pieces;
+    m_replay.endTime = s.ticks;
+}
+
+// --- Odczyt ---
+
+bool ReplayReader::next(ReplayEvent& ev) {
+    uint32_t v;
+    if (m_data >= m_end || !getVarint(m_data, m_end, v))
+        return false;
+    m_time += v >> 3;
+    ev.time = m_time;
+    ev.action = (Action)(v & 7);
+    return ev.action < ACT_COUNT;
+}
+
+void beginReplay(GameState& s, const ReplayView& r) {
+    resetBoard(s, r.seed, r.randomizer);
+    spawnNewPiece(s);
+}
+
+bool verifyReplay(const ReplayView& r, GameState* out) {
+    GameState s;
+    beginReplay(s, r);
+
+    ReplayReader reader(r);
+    ReplayEvent ev;
+    uint32_t n = 0;
+    while (n < r.eventCount && reader.next(ev)) {
+        playEvent(s, ev, r.version);
+        ++n;
+    }
+    // gra mogła skończyć się po ostatniej akcji – na grawitacji
+    if (r.version >= 2)
+        runTicks(s, r.endTime);
+
+    if (out)
+        *out = s;
+    return n == r.eventCount && s.score == r.score && s.lines == r.lines && s.pieces == r.pieces;
+}
+
+// --- Pliki ---
+
+void serializeReplay(const Replay& r, std::vector<uint8_t>& out) {
+    out.insert(out.end(), REPLAY_MAGIC, REPLAY_MAGIC + 4);
+    out.push_back(r.version);
+    out.push_back((uint8_t)r.randomizer);
+    out.push_back(0);
+    out.push_back(0);
+    putU64(out, r.seed);
+    putU32(out, (uint32_t)r.score);
+    putU32(out, (uint32_t)r.lines);
+    putU32(out, (uint32_t)r.pieces);
+    putU32(out, r.eventCount);
+    putU32(out, (uint32_t)r.data.size());
+    if (r.version >= 2)
+        putU32(out, r.endTime);
+    out.insert(out.end(), r.data.begin(), r.data.end());
+}
+
+size_t parseReplay(const uint8_t* data, size_t size, ReplayView& v) {
+    if (size < REPLAY_HEADER_SIZE_V1 || std::memcmp(data, REPLAY_MAGIC, 4) != 0 ||
+        data[4] < 1 || data[4] > REPLAY_VERSION)
+        return 0;
+    v.version = data[4];
+    size_t headerSize = v.version >= 2 ? REPLAY_HEADER_SIZE : REPLAY_HEADER_SIZE_V1;
+    if (size < headerSize)
+        return 0;
+    const uint8_t* p = data + 8;
+    v.randomizer = (Randomizer)data[5];
+    v.seed = getU64(p);              p += 8;
+    v.score = (int)getU32(p);        p += 4;
+    v.lines = (int)getU32(p);        p += 4;
+    v.pieces = (int)getU32(p);       p += 4;
+    v.eventCount = getU32(p);        p += 4;
+    uint32_t dataSize = getU32(p);   p += 4;
+    v.endTime = 0;
+    if (v.version >= 2) {
+        v.endTime = getU32(p);
+        p += 4;
+    }
+    if (dataSize > size - headerSize)
+        return 0;
+    v.data = p;
+    v.size = dataSize;
+    return headerSize + dataSize;
+}
+
+size_t deserializeReplay(const uint8_t* data, size_t size, Replay& r) {
+    ReplayView v;
+    size_t used = parseReplay(data, size, v);
+    if (used == 0)
+        return 0;
+    r.version = v.version;
+    r.seed = v.seed;
+    r.randomizer = v.randomizer;
+    r.score = v.score;
+    r.lines = v.lines;
+    r.pieces = v.pieces;
+    r.eventCount = v.eventCount;
+    r.endTime = v.endTime;
+    r.data.assign(v.data, v.data + v.size);
+    return used;
+}
+
+bool saveReplay(const char* path, const Replay& r) {
+    std::vector<uint8_t> bytes;
+    serializeReplay(r, bytes);
+    FILE* f = fopen(path, "wb");
+    if (!f)
+        return false;
+    bool ok = fwrite(bytes.data(), 1, bytes.size(), f) == bytes.size();
+    return fclose(f) == 0 && ok;
+}
+
+bool loadReplay(const char* path, Replay& r) {
+    FILE* f = fopen(path, "rb");
+    if (!f)
+        return false;
+    std::vector<uint8_t> bytes;
+    uint8_t buf[4096];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), f)) > 0)
+        bytes.insert(bytes.end(), buf, buf + n);
+    fclose(f);
+    return deserializeReplay(bytes.data(), bytes.size(), r) != 0;
+}
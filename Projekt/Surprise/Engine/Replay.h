@@ -0,0 +1,114 @@
+﻿#pragma once
+
+// Zapis gry: ziarno + strumień akcji z czasem. Czas jest kodowany jako
+// różnica od poprzedniej akcji, razem z kodem akcji w jednym varincie:
+// (dt << 3) | akcja, zwykle 1-2 bajty na zdarzenie.
+// Silnik jest deterministyczny, więc ziarno i akcje wystarczą,
+// żeby odtworzyć grę co do bitu.
+//
+// Wersja 1: czas w ms, grawitacja zapisana jako akcje ACT_DOWN.
+// Wersja 2: czas w tikach (TICKS_PER_SECOND); grawitację liczy silnik,
+// więc przed każdą akcją odtwarzanie dogrywa tiki do jej chwili.
+
+#include <cstdint>
+#include <vector>
+
+#include "Engine.h"
+
+const uint8_t REPLAY_VERSION = 2;
+
+struct ReplayEvent {
+    uint32_t time;      // od początku gry: tiki (wersja 2) albo ms (wersja 1)
+    Action action;
+};
+
+// Zapis bez kopiowania danych – np. wskaźnik do zmapowanego archiwum
+struct ReplayView {
+    uint8_t version;
+    uint64_t seed;
+    Randomizer randomizer;
+    int score;
+    int lines;
+    int pieces;
+    uint32_t eventCount;
+    uint32_t endTime;   // tik końca gry (wersja 2)
+    const uint8_t* data;
+    size_t size;
+};
+
+struct Replay {
+    uint8_t version = REPLAY_VERSION;
+    uint64_t seed = 0;
+    Randomizer randomizer = RANDOMIZER_UNIFORM;
+    // wynik zapisany przy nagraniu – do weryfikacji
+    int score = 0;
+    int lines = 0;
+    int pieces = 0;
+    uint32_t eventCount = 0;
+    uint32_t endTime = 0;
+    std::vector<uint8_t> data;   // zakodowane zdarzenia
+
+    ReplayView view() const;
+};
+
+// --- Nagrywanie ---
+class ReplayRecorder {
+public:
+    void begin(uint64_t seed, Randomizer randomizer);
+    // time – bieżący GameState::ticks
+    void record(uint32_t time, Action action);
+    // zapamiętuje końcowy wynik gry i tik końca
+    void finish(const GameState& s);
+
+    const Replay& replay() const { return m_replay; }
+
+private:
+    Replay m_replay;
+    uint32_t m_lastTime = 0;
+};
+
+// --- Odczyt zdarzeń po kolei ---
+class ReplayReader {
+public:
+    // startTime – czas zdarzenia poprzedzającego data (przy starcie od klatki kluczowej)
+    ReplayReader(const uint8_t* data, size_t size, uint32_t startTime = 0)
+        : m_data(data), m_end(data + size), m_time(startTime) {}
+    explicit ReplayReader(const ReplayView& v) : ReplayReader(v.data, v.size) {}
+    explicit ReplayReader(const Replay& r) : ReplayReader(r.data.data(), r.data.size()) {}
+
+    // false na końcu strumienia albo przy uszkodzonych danych
+    bool next(ReplayEvent& ev);
+    size_t offset(const uint8_t* base) const { return (size_t)(m_data - base); }
+    uint32_t time() const { return m_time; }
+
+private:
+    const uint8_t* m_data;
+    const uint8_t* m_end;
+    uint32_t m_time;
+};
+
+// Wykonuje zdarzenie zapisu; w wersji 2 najpierw tiki do jego chwili
+inline void playEvent(GameState& s, const ReplayEvent& ev, uint8_t version) {
+    if (version >= 2)
+        runTicks(s, ev.time);
+    applyAction(s, ev.action);
+}
+
+// Gra na starcie odtwarzania (reset + pierwsza figura)
+void beginReplay(GameState& s, const ReplayView& v);
+inline void beginReplay(GameState& s, const Replay& r) { beginReplay(s, r.view()); }
+
+// Odtwarza całą grę bez okna z pełną prędkością. Zwraca true, jeśli wynik,
+// linie i liczba figur zgadzają się z zapisanymi. Stan końcowy trafia do out.
+bool verifyReplay(const ReplayView& v, GameState* out = nullptr);
+inline bool verifyReplay(const Replay& r, GameState* out = nullptr) { return verifyReplay(r.view(), out); }
+
+// --- Pliki ---
+void serializeReplay(const Replay& r, std::vector<uint8_t>& out);
+// Odczyt z bufora; zwraca liczbę zużytych bajtów albo 0 przy błędzie.
+// parseReplay nie kopiuje zdarzeń – widok wskazuje do bufora.
+size_t parseReplay(const uint8_t* data, size_t size, ReplayView& v);
+size_t deserializeReplay(const uint8_t* data, size_t size, Replay& r);
+
+bool saveReplay(const char* path, const Replay& r);
+bool loadReplay(const char* path, Replay& r);
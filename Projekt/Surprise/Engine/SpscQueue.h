@@ -0,0 +1,61 @@
+﻿#pragma once
+
+// Kolejka bez blokad dla jednego producenta i jednego konsumenta (np. okno
+// wkłada zdarzenia klawiszy, wątek symulacji je zdejmuje). Indeksy rosną
+// bez końca, pozycja w tablicy to indeks & (N - 1). Każda strona trzyma
+// kopię indeksu drugiej strony, żeby nie czytać cudzej linii cache co wywołanie.
+
+#include <atomic>
+#include <cstdint>
+
+template <typename T, uint32_t N>
+class SpscQueue {
+    static_assert(N > 0 && (N & (N - 1)) == 0, "N musi byc potega dwojki");
+
+public:
+    // Producent. Pełna kolejka – false, element przepada.
+    bool push(const T& item) {
+        uint32_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail - m_headCache == N) {
+            m_headCache = m_head.load(std::memory_order_acquire);
+            if (tail - m_headCache == N)
+                return false;
+        }
+        m_items[tail & (N - 1)] = item;
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Konsument: najstarszy element bez zdejmowania
+    bool peek(T& item) {
+        uint32_t head = m_head.load(std::memory_order_relaxed);
+        if (head == m_tailCache) {
+            m_tailCache = m_tail.load(std::memory_order_acquire);
+            if (head == m_tailCache)
+                return false;
+        }
+        item = m_items[head & (N - 1)];
+        return true;
+    }
+
+    // Konsument: zdejmuje element zwrócony przez peek
+    void pop() {
+        uint32_t head = m_head.load(std::memory_order_relaxed);
+        if (head != m_tailCache)
+            m_head.store(head + 1, std::memory_order_release);
+    }
+
+    bool pop(T& item) {
+        if (!peek(item))
+            return false;
+        pop();
+        return true;
+    }
+
+private:
+    alignas(64) std::atomic<uint32_t> m_head{ 0 };   // pisze konsument
+    uint32_t m_tailCache = 0;
+    alignas(64) std::atomic<uint32_t> m_tail{ 0 };   // pisze producent
+    uint32_t m_headCache = 0;
+    alignas(64) T m_items[N];
+};
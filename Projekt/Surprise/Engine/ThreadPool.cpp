@@ -0,0 +1,132 @@
+﻿#include "ThreadPool.h"
+
+static uint64_t packRange(uint32_t begin, uint32_t end) {
+    return ((uint64_t)begin << 32) | end;
+}
+
+static uint32_t rangeBegin(uint64_t r) { return (uint32_t)(r >> 32); }
+static uint32_t rangeEnd(uint64_t r) { return (uint32_t)r; }
+
+static int resolveThreads(int threads) {
+    if (threads > 0)
+        return threads;
+    unsigned hw = std::thread::hardware_concurrency();
+    return hw > 0 ? (int)hw : 1;
+}
+
+ThreadPool::ThreadPool(int threads) : m_slots(resolveThreads(threads)) {
+    // wątek 0 to wątek wywołujący parallelFor, pozostałe czekają w puli
+    for (int i = 1; i < threadCount(); ++i)
+        m_threads.emplace_back(&ThreadPool::workerLoop, this, i);
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_quit = true;
+    }
+    m_start.notify_all();
+    for (std::thread& t : m_threads)
+        t.join();
+}
+
+bool ThreadPool::popLocal(int worker, int& index) {
+    std::atomic<uint64_t>& range = m_slots[worker].range;
+    uint64_t r = range.load(std::memory_order_relaxed);
+    while (rangeBegin(r) < rangeEnd(r)) {
+        if (range.compare_exchange_weak(r, packRange(rangeBegin(r) + 1, rangeEnd(r)),
+                                        std::memory_order_acq_rel)) {
+            index = (int)rangeBegin(r);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ThreadPool::steal(int worker) {
+    for (;;) {
+        // ofiara: wątek z największą liczbą pozostałych zadań
+        int victim = -1;
+        uint32_t best = 0;
+        for (int i = 0; i < threadCount(); ++i) {
+            uint64_t r = m_slots[i].range.load(std::memory_order_relaxed);
+            uint32_t left = rangeEnd(r) - rangeBegin(r);
+            if (rangeBegin(r) < rangeEnd(r) && left > best) {
+                best = left;
+                victim = i;
+            }
+        }
+        if (victim < 0)
+            return false;
+
+        std::atomic<uint64_t>& range = m_slots[victim].range;
+        uint64_t r = range.load(std::memory_order_relaxed);
+        uint32_t begin = rangeBegin(r);
+        uint32_t end = rangeEnd(r);
+        if (begin >= end)
+            continue;
+        uint32_t mid = end - (end - begin + 1) / 2;
+        if (range.compare_exchange_strong(r, packRange(begin, mid), std::memory_order_acq_rel)) {
+            // własny przedział jest pusty, więc nikt inny go teraz nie modyfikuje
+            m_slots[worker].range.store(packRange(mid, end), std::memory_order_release);
+            return true;
+        }
+    }
+}
+
+void ThreadPool::runWorker(int worker) {
+    const std::function<void(int, int)>& fn = *m_job;
+    int index;
+    for (;;) {
+        while (popLocal(worker, index))
+            fn(index, worker);
+        if (!steal(worker))
+            break;
+    }
+}
+
+void ThreadPool::workerLoop(int worker) {
+    uint64_t seen = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_start.wait(lock, [&] { return m_quit || m_generation != seen; });
+            if (m_quit)
+                return;
+            seen = m_generation;
+        }
+        runWorker(worker);
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (--m_running == 0)
+                m_done.notify_one();
+        }
+    }
+}
+
+void ThreadPool::parallelFor(int count, const std::function<void(int index, int worker)>& fn) {
+    if (count <= 0)
+        return;
+
+    // równy podział na starcie, potem wyrównuje podkradanie
+    int n = threadCount();
+    for (int i = 0; i < n; ++i) {
+        uint32_t begin = (uint32_t)((int64_t)count * i / n);
+        uint32_t end = (uint32_t)((int64_t)count * (i + 1) / n);
+        m_slots[i].range.store(packRange(begin, end), std::memory_order_relaxed);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_job = &fn;
+        m_running = n - 1;
+        ++m_generation;
+    }
+    m_start.notify_all();
+
+    runWorker(0);
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_done.wait(lock, [&] { return m_running == 0; });
+    m_job = nullptr;
+}
@@ -0,0 +1,52 @@
+﻿#pragma once
+
+// Pula wątków z podkradaniem pracy (work stealing) do uruchamiania wielu
+// niezależnych zadań, np. całych gier. Każdy wątek dostaje swój ciągły
+// przedział indeksów i bierze zadania z jego początku; gdy skończy,
+// podkrada drugą połowę przedziału najbardziej obciążonego wątku.
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class ThreadPool {
+public:
+    // threads <= 0 -> tyle wątków, ile rdzeni
+    explicit ThreadPool(int threads = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    int threadCount() const { return (int)m_slots.size(); }
+
+    // Wywołuje fn(index, worker) dla index = 0..count-1 i czeka na koniec.
+    // worker to numer wątku 0..threadCount()-1 (np. do buforów na wątek).
+    void parallelFor(int count, const std::function<void(int index, int worker)>& fn);
+
+private:
+    // przedział [begin, end) spakowany w jedno słowo: begin << 32 | end
+    struct alignas(64) Slot {
+        std::atomic<uint64_t> range{ 0 };
+    };
+
+    bool popLocal(int worker, int& index);
+    bool steal(int worker);
+    void runWorker(int worker);
+    void workerLoop(int worker);
+
+    std::vector<Slot> m_slots;
+    std::vector<std::thread> m_threads;
+
+    std::mutex m_mutex;
+    std::condition_variable m_start;
+    std::condition_variable m_done;
+    const std::function<void(int, int)>* m_job = nullptr;
+    uint64_t m_generation = 0;
+    int m_running = 0;
+    bool m_quit = false;
+};
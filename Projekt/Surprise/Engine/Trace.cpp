@@ -0,0 +1,112 @@
+﻿#include "Trace.h"
+
+#ifdef TETRIS_TRACE
+
+#include <atomic>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace {
+
+const uint32_t BUFFER_EVENTS = 1 << 16;   // na wątek, potęga dwójki
+
+struct TraceEvent {
+    const char* name;
+    int64_t beginNs;
+    int64_t endNs;
+};
+
+struct TraceBuffer {
+    uint32_t tid = 0;
+    const char* threadName = nullptr;
+    std::atomic<uint32_t> count{ 0 };
+    TraceEvent events[BUFFER_EVENTS];
+};
+
+// Bufory żyją do końca programu – wątek może się skończyć przed zapisem
+std::mutex g_buffersMutex;
+std::vector<std::unique_ptr<TraceBuffer>> g_buffers;
+
+thread_local TraceBuffer* t_buffer = nullptr;
+
+TraceBuffer* threadBuffer() {
+    if (!t_buffer) {
+        std::unique_ptr<TraceBuffer> b(new TraceBuffer());
+        std::lock_guard<std::mutex> lock(g_buffersMutex);
+        b->tid = (uint32_t)g_buffers.size() + 1;
+        t_buffer = b.get();
+        g_buffers.push_back(std::move(b));
+    }
+    return t_buffer;
+}
+
+void writeString(FILE* f, const char* s) {
+    fputc('"', f);
+    for (; *s; ++s) {
+        if (*s == '"' || *s == '\\')
+            fputc('\\', f);
+        fputc(*s, f);
+    }
+    fputc('"', f);
+}
+
+} // namespace
+
+void traceRecord(const char* name, int64_t beginNs, int64_t endNs) {
+    TraceBuffer* b = threadBuffer();
+    uint32_t n = b->count.load(std::memory_order_relaxed);
+    b->events[n & (BUFFER_EVENTS - 1)] = TraceEvent{ name, beginNs, endNs };
+    b->count.store(n + 1, std::memory_order_release);
+}
+
+void traceThreadName(const char* name) {
+    threadBuffer()->threadName = name;
+}
+
+bool traceWrite(const char* path) {
+    FILE* f = fopen(path, "w");
+    if (!f)
+        return false;
+
+    std::lock_guard<std::mutex> lock(g_buffersMutex);
+
+    // czasy w pliku liczone od najwcześniejszego zachowanego zdarzenia
+    int64_t origin = INT64_MAX;
+    for (const auto& b : g_buffers) {
+        uint32_t count = b->count.load(std::memory_order_acquire);
+        uint32_t first = count > BUFFER_EVENTS ? count - BUFFER_EVENTS : 0;
+        for (uint32_t i = first; i < count; ++i) {
+            const TraceEvent& e = b->events[i & (BUFFER_EVENTS - 1)];
+            if (e.beginNs < origin)
+                origin = e.beginNs;
+        }
+    }
+
+    fprintf(f, "{\"traceEvents\":[\n");
+    bool firstEvent = true;
+    for (const auto& b : g_buffers) {
+        if (b->threadName) {
+            fprintf(f, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":",
+                    firstEvent ? "" : ",\n", b->tid);
+            writeString(f, b->threadName);
+            fprintf(f, "}}");
+            firstEvent = false;
+        }
+        uint32_t count = b->count.load(std::memory_order_acquire);
+        uint32_t first = count > BUFFER_EVENTS ? count - BUFFER_EVENTS : 0;
+        for (uint32_t i = first; i < count; ++i) {
+            const TraceEvent& e = b->events[i & (BUFFER_EVENTS - 1)];
+            fprintf(f, "%s{\"name\":", firstEvent ? "" : ",\n");
+            writeString(f, e.name);
+            fprintf(f, ",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+                    b->tid, (e.beginNs - origin) / 1000.0, (e.endNs - e.beginNs) / 1000.0);
+            firstEvent = false;
+        }
+    }
+    fprintf(f, "\n]}\n");
+    return fclose(f) == 0;
+}
+
+#endif
@@ -0,0 +1,48 @@
+﻿#pragma once
+
+// Ślady do przeglądarki Chrome (chrome://tracing, Perfetto). TRACE_SCOPE("nazwa")
+// zapisuje przedział od miejsca wywołania do końca bloku; każdy wątek pisze
+// do własnego bufora pierścieniowego (najstarsze zdarzenia są nadpisywane),
+// a TRACE_WRITE(plik) zapisuje wszystkie bufory w formacie Trace Event JSON.
+//
+// Bez TETRIS_TRACE (domyślnie) makra rozwijają się do niczego – argumenty
+// nie są nawet obliczane. Nazwy muszą żyć do zapisu (literały napisowe).
+
+#ifdef TETRIS_TRACE
+
+#include <cstdint>
+
+#include "Clock.h"
+
+void traceRecord(const char* name, int64_t beginNs, int64_t endNs);
+void traceThreadName(const char* name);
+// Zapis najlepiej po zatrzymaniu pozostałych wątków – zdarzenia
+// dopisywane w trakcie mogą trafić do pliku niekompletne
+bool traceWrite(const char* path);
+
+class TraceScope {
+public:
+    explicit TraceScope(const char* name) : m_name(name), m_beginNs(clockNowNs()) {}
+    ~TraceScope() { traceRecord(m_name, m_beginNs, clockNowNs()); }
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+    const char* m_name;
+    int64_t m_beginNs;
+};
+
+#define TRACE_JOIN2(a, b) a##b
+#define TRACE_JOIN(a, b) TRACE_JOIN2(a, b)
+#define TRACE_SCOPE(name) TraceScope TRACE_JOIN(traceScope_, __LINE__)(name)
+#define TRACE_THREAD_NAME(name) traceThreadName(name)
+#define TRACE_WRITE(path) traceWrite(path)
+
+#else
+
+#define TRACE_SCOPE(name) ((void)0)
+#define TRACE_THREAD_NAME(name) ((void)0)
+#define TRACE_WRITE(path) ((void)0)
+
+#endif
@@ -0,0 +1,13 @@
+﻿#include "Transposition.h"
+
+TranspositionTable::TranspositionTable(int bits)
+    : m_entries(new Entry[(size_t)1 << bits]), m_mask(((size_t)1 << bits) - 1) {
+    clear();
+}
+
+void TranspositionTable::clear() {
+    for (size_t i = 0; i <= m_mask; ++i) {
+        m_entries[i].check.store(0, std::memory_order_relaxed);
+        m_entries[i].data.store(0, std::memory_order_relaxed);
+    }
+}
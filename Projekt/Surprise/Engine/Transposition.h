@@ -0,0 +1,73 @@
+﻿#pragma once
+
+// Tablica transpozycji: pamięć ocen plansz widzianych już przy
+// przeszukiwaniu, kluczowana skrótem Zobrista (Board::hash). Stały rozmiar
+// (2^bits wpisów), jeden wpis na pozycję, nowy zawsze nadpisuje stary.
+//
+// Bez blokad – wiele wątków (botów) może czytać i pisać naraz. Wpis to
+// dwa słowa: dane i klucz XOR dane. Rozerwany zapis (słowa z dwóch różnych
+// zapisów) nie przejdzie sprawdzenia klucza, więc odczyt zwraca albo
+// poprawną wartość, albo nic.
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+
+#ifdef _MSC_VER
+#include <xmmintrin.h>
+#endif
+
+class TranspositionTable {
+public:
+    explicit TranspositionTable(int bits = 20);
+
+    TranspositionTable(const TranspositionTable&) = delete;
+    TranspositionTable& operator=(const TranspositionTable&) = delete;
+
+    size_t size() const { return m_mask + 1; }
+    size_t bytes() const { return size() * sizeof(Entry); }
+
+    // Prośba o wpis klucza do pamięci podręcznej – przed probe()
+    void prefetch(uint64_t key) const {
+#ifdef _MSC_VER
+        _mm_prefetch((const char*)&m_entries[key & m_mask], _MM_HINT_T0);
+#else
+        __builtin_prefetch(&m_entries[key & m_mask]);
+#endif
+    }
+
+    bool probe(uint64_t key, float& value) const {
+        const Entry& e = m_entries[key & m_mask];
+        uint64_t data = e.data.load(std::memory_order_relaxed);
+        uint64_t check = e.check.load(std::memory_order_relaxed);
+        if ((check ^ data) != key || !(data & VALID))
+            return false;
+        uint32_t bits = (uint32_t)data;
+        std::memcpy(&value, &bits, sizeof(value));
+        return true;
+    }
+
+    void store(uint64_t key, float value) {
+        uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        uint64_t data = VALID | bits;
+        Entry& e = m_entries[key & m_mask];
+        e.data.store(data, std::memory_order_relaxed);
+        e.check.store(key ^ data, std::memory_order_relaxed);
+    }
+
+    void clear();
+
+private:
+    static const uint64_t VALID = 1ull << 32;   // pusty wpis (same zera) nie pasuje do żadnego klucza
+
+    struct Entry {
+        std::atomic<uint64_t> check;   // klucz XOR data
+        std::atomic<uint64_t> data;    // VALID | bity float
+    };
+
+    std::unique_ptr<Entry[]> m_entries;
+    size_t m_mask;
+};
@@ -0,0 +1,46 @@
+﻿#pragma once
+
+// Potrójny bufor: pisarz wypełnia swój egzemplarz i publikuje go jedną
+// wymianą atomową, czytelnik bierze najnowszy opublikowany. Żadna strona
+// nie czeka na drugą; czytelnik może przegapić pośrednie egzemplarze,
+// jeśli pisarz publikuje szybciej, niż on czyta.
+
+#include <atomic>
+#include <cstdint>
+
+template <typename T>
+class TripleBuffer {
+public:
+    // Pisarz: egzemplarz do wypełnienia
+    T& back() { return m_slots[m_back].value; }
+
+    // Pisarz: oddaje back() czytelnikowi i dostaje wolny egzemplarz
+    void publish() {
+        m_back = m_middle.exchange((uint8_t)(m_back | FRESH), std::memory_order_acq_rel) & INDEX;
+    }
+
+    // Czytelnik: przełącza front() na najnowszy egzemplarz; false, gdy
+    // od ostatniego razu nic nie opublikowano
+    bool acquire() {
+        if (!(m_middle.load(std::memory_order_relaxed) & FRESH))
+            return false;
+        m_front = m_middle.exchange(m_front, std::memory_order_acq_rel) & INDEX;
+        return true;
+    }
+
+    // Czytelnik: egzemplarz niezmienny aż do następnego acquire()
+    const T& front() const { return m_slots[m_front].value; }
+
+private:
+    static const uint8_t INDEX = 3;
+    static const uint8_t FRESH = 4;
+
+    struct alignas(64) Slot {
+        T value;
+    };
+
+    Slot m_slots[3];
+    uint8_t m_back = 0;                      // tylko pisarz
+    alignas(64) std::atomic<uint8_t> m_middle{ 1 };
+    alignas(64) uint8_t m_front = 2;         // tylko czytelnik
+};
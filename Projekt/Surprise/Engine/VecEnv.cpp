@@ -0,0 +1,98 @@
+﻿#include "VecEnv.h"
+
+#include <cstring>
+
+#include "ThreadPool.h"
+
+// Gry na zadanie puli wątków – mniej synchronizacji niż zadanie na grę
+const int ENV_CHUNK = 64;
+
+VecEnv::VecEnv(int count, const VecEnvConfig& config)
+    : m_config(config), m_games(count), m_seeds(count, 0), m_episodes(count, 0),
+      m_nextShape(count, 0), m_nextForPiece(count, -1) {
+    for (int i = 0; i < count; ++i)
+        startEpisode(i);
+}
+
+void VecEnv::startEpisode(int i) {
+    GameState& s = m_games[i];
+    resetBoard(s, deriveSeed(m_seeds[i], m_episodes[i]), m_config.randomizer);
+    spawnNewPiece(s);
+    m_nextForPiece[i] = -1;
+}
+
+void VecEnv::reset(const uint64_t* seeds, float* obs) {
+    for (int i = 0; i < count(); ++i) {
+        m_seeds[i] = seeds[i];
+        m_episodes[i] = 0;
+        startEpisode(i);
+        writeObservation(i, obs + (size_t)i * OBS_SIZE);
+    }
+}
+
+void VecEnv::step(const Action* actions, float* obs, float* rewards, uint8_t* dones) {
+    m_actions = actions;
+    m_obs = obs;
+    m_rewards = rewards;
+    m_dones = dones;
+    int n = count();
+    if (m_config.pool && n > ENV_CHUNK) {
+        // łapiemy tylko this – std::function nie alokuje
+        m_config.pool->parallelFor((n + ENV_CHUNK - 1) / ENV_CHUNK, [this](int chunk, int) {
+            int begin = chunk * ENV_CHUNK;
+            int end = begin + ENV_CHUNK < count() ? begin + ENV_CHUNK : count();
+            stepRange(begin, end);
+        });
+    } else {
+        stepRange(0, n);
+    }
+}
+
+void VecEnv::stepRange(int begin, int end) {
+    for (int i = begin; i < end; ++i) {
+        GameState& s = m_games[i];
+        int score = s.score;
+        applyAction(s, m_actions[i]);
+        if (m_config.ticksPerStep > 0 && !s.gameOver)
+            runTicks(s, s.ticks + (uint32_t)m_config.ticksPerStep);
+
+        float reward = (float)(s.score - score);
+        bool done = s.gameOver || (m_config.maxPieces > 0 && s.pieces > m_config.maxPieces);
+        if (s.gameOver)
+            reward += m_config.gameOverReward;
+        if (done) {
+            ++m_episodes[i];
+            startEpisode(i);
+        }
+        m_rewards[i] = reward;
+        m_dones[i] = done ? 1 : 0;
+        writeObservation(i, m_obs + (size_t)i * OBS_SIZE);
+    }
+}
+
+void VecEnv::writeObservation(int i, float* obs) {
+    const GameState& s = m_games[i];
+    const Board& b = s.board;
+    for (int y = 0; y < BOARD_H; ++y)
+        for (int x = 0; x < BOARD_W; ++x)
+            obs[OBS_BOARD + y * BOARD_W + x] = (float)((b.rows[y] >> x) & 1u);
+
+    std::memset(obs + OBS_PIECE, 0, sizeof(float) * BOARD_H * BOARD_W);
+    Block blocks[4];
+    getPieceBlocks(s.currentPiece, blocks);
+    for (int k = 0; k < 4; ++k) {
+        if (blocks[k].x >= 0 && blocks[k].x < BOARD_W && blocks[k].y >= 0 && blocks[k].y < BOARD_H)
+            obs[OBS_PIECE + blocks[k].y * BOARD_W + blocks[k].x] = 1;
+    }
+
+    for (int x = 0; x < BOARD_W; ++x)
+        obs[OBS_HEIGHTS + x] = (float)b.heights[x];
+
+    if (m_nextForPiece[i] != s.pieces) {
+        peekShapes(s, &m_nextShape[i], 1);
+        m_nextForPiece[i] = s.pieces;
+    }
+    std::memset(obs + OBS_CURRENT, 0, sizeof(float) * (OBS_SIZE - OBS_CURRENT));
+    obs[OBS_CURRENT + s.currentPiece.shape] = 1;
+    obs[OBS_NEXT + m_nextShape[i]] = 1;
+}
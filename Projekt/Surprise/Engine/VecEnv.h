@@ -0,0 +1,72 @@
+﻿#pragma once
+
+// Wiele gier naraz z interfejsem w stylu Gym (VecEnv) – do uczenia ze
+// wzmocnieniem. reset(seeds) i step(actions) piszą obserwacje, nagrody
+// i flagi końca prosto do ciągłych buforów wołającego; krok niczego nie
+// alokuje ani nie kopiuje stanu gry (podgląd następnej figury kopiuje
+// tylko generator losowy i worek).
+//
+// Krok to samo, co robi okno: jedna akcja gracza (applyAction, czyli
+// movePiece/rotatePiece/hardDrop; ACT_NONE = nic), potem ticksPerStep tików
+// grawitacji i blokowania. Skończona gra (koniec albo limit figur) od razu
+// zaczyna się od nowa: done = 1, nagroda jest z ostatniego kroku starej gry,
+// a obserwacja już z nowej. Kolejne epizody gry i mają ziarna
+// deriveSeed(seeds[i], epizod).
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Engine.h"
+
+class ThreadPool;
+
+// Obserwacja jednej gry: OBS_SIZE liczb float, od przesunięcia:
+const int OBS_BOARD = 0;                                // BOARD_H x BOARD_W: 1 = zajęte (bez figury)
+const int OBS_PIECE = OBS_BOARD + BOARD_H * BOARD_W;    // BOARD_H x BOARD_W: 1 = bieżąca figura
+const int OBS_HEIGHTS = OBS_PIECE + BOARD_H * BOARD_W;  // BOARD_W wysokości kolumn (w wierszach)
+const int OBS_CURRENT = OBS_HEIGHTS + BOARD_W;          // 7: bieżąca figura, one-hot
+const int OBS_NEXT = OBS_CURRENT + 7;                   // 7: następna figura, one-hot
+const int OBS_SIZE = OBS_NEXT + 7;
+
+struct VecEnvConfig {
+    int ticksPerStep = TICKS_PER_SECOND / 10;   // grawitacja między akcjami (0 = brak)
+    int maxPieces = 0;                          // limit zablokowanych figur w epizodzie, 0 = bez limitu
+    float gameOverReward = 0;                   // dodawane do nagrody (punkty) przy końcu gry
+    Randomizer randomizer = RANDOMIZER_UNIFORM;
+    ThreadPool* pool = nullptr;                 // kroki gier na wielu wątkach (nullptr = jeden)
+};
+
+class VecEnv {
+public:
+    explicit VecEnv(int count, const VecEnvConfig& config = VecEnvConfig());
+
+    int count() const { return (int)m_games.size(); }
+    const GameState& state(int i) const { return m_games[i]; }
+    // Numer bieżącego epizodu gry i (0 po reset)
+    uint32_t episode(int i) const { return m_episodes[i]; }
+
+    // Nowe gry z ziaren seeds[0..count-1]; obs: count * OBS_SIZE
+    void reset(const uint64_t* seeds, float* obs);
+
+    // Akcja dla każdej gry; obs: count * OBS_SIZE, rewards i dones: count
+    void step(const Action* actions, float* obs, float* rewards, uint8_t* dones);
+
+private:
+    void startEpisode(int i);
+    void stepRange(int begin, int end);
+    void writeObservation(int i, float* obs);
+
+    VecEnvConfig m_config;
+    std::vector<GameState> m_games;
+    std::vector<uint64_t> m_seeds;
+    std::vector<uint32_t> m_episodes;
+    std::vector<int> m_nextShape;       // podgląd liczony raz na figurę
+    std::vector<int> m_nextForPiece;    // GameState::pieces, dla którego m_nextShape jest aktualny
+
+    // argumenty bieżącego step() dla wątków puli
+    const Action* m_actions = nullptr;
+    float* m_obs = nullptr;
+    float* m_rewards = nullptr;
+    uint8_t* m_dones = nullptr;
+};
@@ -1,377 +1,619 @@
 ﻿#include <windows.h>
+#include <atomic>
+#include <cstdio>
 #include <ctime>
+#include <thread>
+
+#include "Bot.h"
+#include "Clock.h"
+#include "Engine.h"
+#include "GdiRenderer.h"
+#include "Histogram.h"
+#include "Input.h"
+#include "Replay.h"
+#include "Trace.h"
+#include "TripleBuffer.h"
 
 #pragma comment(lib, "user32.lib")
 #pragma comment(lib, "gdi32.lib")
+#pragma comment(lib, "winmm.lib")
 
-// --- Konfiguracja gry ---
-const int BOARD_W = 10;
-const int BOARD_H = 20;
+// --- Konfiguracja okna ---
 const int CELL_SIZE = 24;
 
-const UINT ID_TIMER = 1;
-const UINT TIMER_INTERVAL = 600; // ms, tempo spadania
-
-// --- Struktury gry ---
-struct Piece {
-    int x;       // pozycja w komórkach (kolumna)
-    int y;       // pozycja w komórkach (wiersz)
-    int shape;   // 0..6
-    int rot;     // 0..3
+// zapis ostatniej gry (w katalogu roboczym)
+const char LAST_REPLAY_FILE[] = "ostatnia_gra.rpl";
+// histogramy czasów zapisywane przy zamknięciu okna
+const char LATENCY_FILE[] = "opoznienia.txt";
+// ślad Chrome (tylko w kompilacji z TETRIS_TRACE)
+const char TRACE_FILE[] = "slad.json";
+
+// Stan gry należy do wątku symulacji (reguły w Engine). Okno go nie czyta –
+// rysuje niezmienne kopie publikowane przez potrójny bufor, więc wolne
+// rysowanie nie wstrzymuje zegara gry, a tik nie czeka na WM_PAINT.
+GameState g_game;
+
+// Kopia stanu dla okna; game.dirty to zmiany od poprzedniej kopii
+struct FrameSnapshot {
+    GameState game;
+    uint32_t seq;
+    int64_t inputNs;    // najwcześniejsza akcja gracza widoczna w tej kopii, -1 – brak
 };
 
-// globalny stan gry
-int board[BOARD_H][BOARD_W] = { 0 };
-Piece currentPiece;
-bool gameOver = false;
-int score = 0;
-
-// kolory dla figur (1..7)
-COLORREF g_colors[8] = {
-    RGB(0, 0, 0),         // 0 - puste
-    RGB(0, 255, 255),     // 1 - I
-    RGB(0, 0, 255),       // 2 - J
-    RGB(255, 165, 0),     // 3 - L (pomarańczowy)
-    RGB(255, 255, 0),     // 4 - O
-    RGB(0, 255, 0),       // 5 - S
-    RGB(160, 32, 240),    // 6 - T (fiolet)
-    RGB(255, 0, 0)        // 7 - Z
-};
+const UINT WM_APP_FRAME = WM_APP + 1;   // wątek symulacji -> okno: jest nowa kopia
+
+TripleBuffer<FrameSnapshot> g_frames;
+uint32_t g_publishedSeq = 0;              // wątek symulacji
+uint32_t g_shownSeq = 0;                  // okno
+std::atomic<bool> g_framePosted{ false }; // WM_APP_FRAME czeka w kolejce okna
+
+std::thread g_simThread;
+HANDLE g_wakeEvent = nullptr;             // budzi wątek symulacji (wejście, koniec)
+std::atomic<bool> g_restartRequested{ false };
+std::atomic<bool> g_quit{ false };
+HWND g_hwnd = nullptr;
+
+// Pomiary: od naciśnięcia klawisza (albo zaplanowanego powtórzenia) do
+// BitBlt klatki, która pokazuje jego skutek; czas tiku (wątek symulacji)
+// i czas WM_PAINT (okno). F3 pokazuje nakładkę z percentylami.
+LatencyHistogram g_inputLatency;
+LatencyHistogram g_tickTime;
+LatencyHistogram g_paintTime;
+int64_t g_pendingInputNs = -1;            // wątek symulacji: akcje od ostatniej kopii
+int64_t g_unpaintedInputNs = -1;          // okno: akcje z kopii jeszcze nienarysowanej
+bool g_overlay = false;
+const UINT_PTR OVERLAY_TIMER = 1;
+
+// zegar logiki: tiki co 1/TICKS_PER_SECOND s, niezależnie od rysowania
+FixedStepClock g_clock(TICKS_PER_SECOND);
+
+// klawisze sterujące: zdarzenia ze znacznikiem czasu (okno -> wątek symulacji),
+// powtarzanie po stronie symulacji
+InputQueue g_inputQueue;
+InputHandler g_input;
+std::atomic<bool> g_inputOverflow{ false };   // zgubione zdarzenie: puścić klawisze
+
+// nagrywanie bieżącej gry (czas zdarzeń w tikach)
+ReplayRecorder g_recorder;
+
+// odtwarzanie zapisu podanego w linii poleceń
+bool g_playback = false;
+Replay g_playbackReplay;
+ReplayReader g_playbackReader(nullptr, 0);
+ReplayEvent g_pendingEvent;
+bool g_hasPendingEvent = false;
+int64_t g_playbackStartNs = 0;    // zapisy w wersji 1 mają czas w ms
+
+// Autopilot (F4): bot planuje drogę figury, wątek symulacji wykonuje ją po
+// jednej akcji co AUTOPLAY_STEP_TICKS tików, więc widać ruchy. Akcje idą
+// przez doAction, więc trafiają do zapisu jak ruchy gracza.
+const uint32_t AUTOPLAY_STEP_TICKS = 3;
+std::atomic<bool> g_autoplay{ false };
+TranspositionTable g_botTable(16);
+
+BotConfig autoplayConfig() {
+    BotConfig c;
+    c.table = &g_botTable;
+    return c;
+}
 
-HBRUSH g_brushes[8] = { 0 };
-
-// definicje klocków w orientacji bazowej (rot = 0) w układzie 4x4
-// współrzędne x,y w obrębie 4x4
-struct Block { int x, y; };
-
-Block baseShapes[7][4] = {
-    // I
-    { {0,1}, {1,1}, {2,1}, {3,1} },
-    // J
-    { {0,0}, {0,1}, {1,1}, {2,1} },
-    // L
-    { {2,0}, {0,1}, {1,1}, {2,1} },
-    // O
-    { {1,0}, {2,0}, {1,1}, {2,1} },
-    // S
-    { {1,0}, {2,0}, {0,1}, {1,1} },
-    // T
-    { {1,0}, {0,1}, {1,1}, {2,1} },
-    // Z
-    { {0,0}, {1,0}, {1,1}, {2,1} }
+Bot g_bot(autoplayConfig());
+Action g_botPlan[64];
+int g_botPlanLength = 0;
+int g_botPlanPos = 0;
+int g_botPlanPiece = -1;          // GameState::pieces, dla którego plan powstał
+uint32_t g_botNextTick = 0;
+
+// Zasoby rysowania tworzone raz na czas życia okna: bufor tylny (pamięciowy
+// DC + sekcja DIB), układ sceny i atlas komórek. Odtwarzane tylko przy
+// zmianie rozmiaru albo DPI, więc klatka niczego nie alokuje.
+struct RenderContext {
+    HDC memDC;
+    HBITMAP backBuffer;
+    HGDIOBJ oldBitmap;
+    uint32_t* pixels;   // piksele sekcji DIB (0xAARRGGBB, wiersze od góry)
+    int width;
+    int height;
+    SceneLayout layout;
 };
 
-// Obrót punktu w macierzy 4x4 (0..3)
-Block rotateBlock(const Block& b, int rot) {
-    Block r = b;
-    for (int i = 0; i < (rot & 3); ++i) {
-        int x = r.x;
-        int y = r.y;
-        // obrót 90° CW: (x, y) -> (3 - y, x)
-        r.x = 3 - y;
-        r.y = x;
-    }
-    return r;
-}
+RenderContext g_render = { 0 };
 
-void getPieceBlocks(const Piece& p, Block out[4]) {
-    for (int i = 0; i < 4; ++i) {
-        Block b = rotateBlock(baseShapes[p.shape][i], p.rot);
-        out[i].x = p.x + b.x;
-        out[i].y = p.y + b.y;
-    }
+// Rysowanie komórek: kafle z atlasu prosto do pikseli bufora (domyślnie)
+// albo wszystko przez GDI. F2 przełącza – do porównań.
+bool g_pixelRenderer = true;
+CellAtlas g_atlas;
+
+// --- Nagrywanie / odtwarzanie ---
+
+void startNewGame() {
+    uint64_t seed = (uint64_t)time(nullptr);
+    resetBoard(g_game, seed);
+    spawnNewPiece(g_game);
+    setDirtyTracking(g_game, true);
+    g_recorder.begin(seed, g_game.randomizer);
+    g_clock.reset(clockNowNs());
 }
 
-bool isCollision(const Piece& p) {
-    Block blocks[4];
-    getPieceBlocks(p, blocks);
-    for (int i = 0; i < 4; ++i) {
-        int x = blocks[i].x;
-        int y = blocks[i].y;
-        if (x < 0 || x >= BOARD_W || y < 0 || y >= BOARD_H)
-            return true;
-        if (board[y][x] != 0)
-            return true;
+void saveIfGameOver() {
+    if (g_game.gameOver) {
+        g_recorder.finish(g_game);
+        saveReplay(LAST_REPLAY_FILE, g_recorder.replay());
     }
-    return false;
 }
 
-void resetBoard() {
-    for (int y = 0; y < BOARD_H; ++y)
-        for (int x = 0; x < BOARD_W; ++x)
-            board[y][x] = 0;
-    score = 0;
-    gameOver = false;
+// Każda akcja gracza przechodzi tędy, żeby trafić do zapisu. Akcje bez
+// skutku (ruch w ścianę przy trzymanym klawiszu) nie zmieniają stanu,
+// więc nie trafiają do zapisu; zwraca, czy akcja coś zmieniła.
+bool doAction(Action a) {
+    if (g_game.gameOver) return false;
+    Piece before = g_game.currentPiece;
+    int pieces = g_game.pieces;
+    applyAction(g_game, a);
+    const Piece& p = g_game.currentPiece;
+    bool changed = g_game.pieces != pieces || p.x != before.x || p.y != before.y || p.rot != before.rot;
+    if (changed)
+        g_recorder.record(g_game.ticks, a);
+    saveIfGameOver();
+    return changed;
 }
 
-void spawnNewPiece() {
-    currentPiece.shape = rand() % 7;
-    currentPiece.rot = 0;
-    currentPiece.x = BOARD_W / 2 - 2;
-    currentPiece.y = 0;
+void startPlayback() {
+    beginReplay(g_game, g_playbackReplay);
+    setDirtyTracking(g_game, true);
+    g_playbackReader = ReplayReader(g_playbackReplay);
+    g_hasPendingEvent = g_playbackReader.next(g_pendingEvent);
+    g_playbackStartNs = clockNowNs();
+    g_clock.reset(g_playbackStartNs);
+}
 
-    if (isCollision(currentPiece)) {
-        gameOver = true;
+// Wykonuje zdarzenia zapisu do bieżącego tiku (wersja 1: do bieżącej ms)
+void advancePlayback() {
+    const Replay& r = g_playbackReplay;
+    bool ticks = r.version >= 2;
+    uint32_t now = ticks ? g_game.ticks + 1 : (uint32_t)((clockNowNs() - g_playbackStartNs) / 1000000);
+    while (g_hasPendingEvent && g_pendingEvent.time <= now) {
+        playEvent(g_game, g_pendingEvent, r.version);
+        g_hasPendingEvent = g_playbackReader.next(g_pendingEvent);
     }
+    if (ticks)
+        runTicks(g_game, now < r.endTime ? now : r.endTime);
 }
 
-void lockPiece() {
-    Block blocks[4];
-    getPieceBlocks(currentPiece, blocks);
-    for (int i = 0; i < 4; ++i) {
-        int x = blocks[i].x;
-        int y = blocks[i].y;
-        if (y >= 0 && y < BOARD_H && x >= 0 && x < BOARD_W) {
-            board[y][x] = currentPiece.shape + 1; // 1..7
+// Wykonuje akcje z warstwy wejścia, które wypadły do tej chwili
+void pollInput() {
+    // bez zgubionego puszczenia klawisz powtarzałby się bez końca
+    if (g_inputOverflow.exchange(false)) {
+        InputEvent ev;
+        while (g_inputQueue.pop(ev)) {
         }
+        g_input.reset();
     }
-}
 
-void clearLines() {
-    int lines = 0;
-    for (int y = BOARD_H - 1; y >= 0; --y) {
-        bool full = true;
-        for (int x = 0; x < BOARD_W; ++x) {
-            if (board[y][x] == 0) {
-                full = false;
-                break;
-            }
-        }
-        if (full) {
-            // przesuń wszystko w dół
-            for (int yy = y; yy > 0; --yy) {
-                for (int x = 0; x < BOARD_W; ++x) {
-                    board[yy][x] = board[yy - 1][x];
-                }
-            }
-            for (int x = 0; x < BOARD_W; ++x) {
-                board[0][x] = 0;
-            }
-            ++lines;
-            ++y; // sprawdź jeszcze raz ten sam wiersz po przesunięciu
+    InputAction actions[64];
+    int n;
+    do {
+        n = g_input.poll(g_inputQueue, clockNowNs(), actions, 64);
+        for (int i = 0; i < n; ++i) {
+            if (g_playback || !doAction(actions[i].action))
+                continue;
+            if (g_pendingInputNs < 0 || actions[i].timeNs < g_pendingInputNs)
+                g_pendingInputNs = actions[i].timeNs;
         }
+    } while (n == 64);
+}
+
+bool inputKeyForVk(WPARAM vk, InputKey& key) {
+    switch (vk) {
+        case VK_LEFT:  key = KEY_LEFT;      return true;
+        case VK_RIGHT: key = KEY_RIGHT;     return true;
+        case VK_DOWN:  key = KEY_SOFT_DROP; return true;
+        case VK_UP:    key = KEY_ROTATE;    return true;
+        case VK_SPACE: key = KEY_HARD_DROP; return true;
+        default:       return false;
     }
-    // prosty system punktów: 100 za linię
-    score += lines * 100;
 }
 
-void movePiece(int dx, int dy) {
-    if (gameOver) return;
-    Piece tmp = currentPiece;
-    tmp.x += dx;
-    tmp.y += dy;
-    if (!isCollision(tmp)) {
-        currentPiece = tmp;
+// Jeden krok logiki, wołany z pętli wątku symulacji
+void simulateTick() {
+    if (g_playback) {
+        advancePlayback();
+        return;
     }
-    else if (dy != 0) {
-        // kolizja przy ruchu w dół -> blokujemy, kasujemy linie, generujemy nową figurę
-        lockPiece();
-        clearLines();
-        spawnNewPiece();
+    if (g_game.gameOver) return;
+    tick(g_game);
+    saveIfGameOver();
+}
+
+// Jeden krok autopilota: nowy plan dla nowej figury (albo gdy akcja nie
+// przeszła), potem następna akcja z planu
+void autoplay() {
+    if (!g_autoplay.load(std::memory_order_relaxed) || g_playback || g_game.gameOver)
+        return;
+    if (g_game.ticks < g_botNextTick)
+        return;
+    g_botNextTick = g_game.ticks + AUTOPLAY_STEP_TICKS;
+
+    if (g_botPlanPiece != g_game.pieces || g_botPlanPos >= g_botPlanLength) {
+        g_botPlanLength = g_bot.think(g_game, g_botPlan, 64);
+        g_botPlanPos = 0;
+        g_botPlanPiece = g_game.pieces;
+        if (g_botPlanLength == 0) {
+            doAction(ACT_HARD_DROP);
+            return;
+        }
     }
+    if (!doAction(g_botPlan[g_botPlanPos++]))
+        g_botPlanPiece = -1;
+}
+
+void startGame() {
+    // plan i licznik tików autopilota dotyczą poprzedniej gry
+    g_botNextTick = 0;
+    g_botPlanPiece = -1;
+    g_botPlanPos = g_botPlanLength = 0;
+    if (g_playback)
+        startPlayback();
+    else
+        startNewGame();
+}
+
+// Oddaje oknu kopię stanu, jeśli coś się zmieniło. Powiadomienie wysyłamy
+// tylko, gdy poprzednie nie zostało jeszcze odebrane.
+void publishFrame() {
+    if (!isDirty(g_game))
+        return;
+    FrameSnapshot& f = g_frames.back();
+    f.game = g_game;
+    f.seq = ++g_publishedSeq;
+    f.inputNs = g_pendingInputNs;
+    g_pendingInputNs = -1;
+    g_frames.publish();
+    clearDirty(g_game);
+    if (g_hwnd && !g_framePosted.exchange(true))
+        PostMessage(g_hwnd, WM_APP_FRAME, 0, 0);
 }
 
-void rotatePiece() {
-    if (gameOver) return;
-    Piece tmp = currentPiece;
-    tmp.rot = (tmp.rot + 1) & 3;
-    if (!isCollision(tmp)) {
-        currentPiece = tmp;
+// Pętla wątku symulacji: polecenia okna, akcje z wejścia, tyle tików, ile
+// wypadło od poprzedniego obiegu, publikacja kopii i sen do następnego tiku,
+// powtórzenia klawisza albo do nowego zdarzenia z okna.
+void simulationLoop() {
+    TRACE_THREAD_NAME("symulacja");
+    while (!g_quit.load(std::memory_order_relaxed)) {
+        if (g_restartRequested.exchange(false))
+            startGame();
+        pollInput();
+        int steps = g_clock.advance(clockNowNs());
+        for (int i = 0; i < steps; ++i) {
+            int64_t t0 = clockNowNs();
+            simulateTick();
+            g_tickTime.record(clockNowNs() - t0);
+        }
+        autoplay();
+        publishFrame();
+
+        int64_t waitNs = g_clock.nsUntilNextStep();
+        int64_t repeat = g_input.nextRepeatNs();
+        if (repeat >= 0 && repeat - clockNowNs() < waitNs)
+            waitNs = repeat - clockNowNs();
+        // w górę do pełnej ms: obcięcie budziłoby wątek tuż przed terminem, na pusto
+        WaitForSingleObject(g_wakeEvent, waitNs > 0 ? (DWORD)((waitNs + 999999) / 1000000) : 0);
     }
 }
 
-// "Hard drop": zrzut na dół
-void hardDrop() {
-    if (gameOver) return;
-    Piece tmp = currentPiece;
-    while (!isCollision(tmp)) {
-        currentPiece = tmp;
-        tmp.y += 1;
+// Okno: przekazuje zdarzenie klawisza wątkowi symulacji
+void sendInput(InputKey key, bool down) {
+    if (!g_inputQueue.push({ clockNowNs(), key, down }))
+        g_inputOverflow.store(true);
+    SetEvent(g_wakeEvent);
+}
+
+// --- Zasoby rysowania ---
+
+void createRenderObjects(HWND hwnd) {
+    UINT dpi = GetDpiForWindow(hwnd);
+    g_render.layout = makeSceneLayout(CELL_SIZE, (int)(2 * dpi / 96));
+    g_atlas.build(CELL_SIZE, PIECE_COLORS, COLOR_BOARD, COLOR_CELL_FRAME);
+}
+
+void destroyBackBuffer() {
+    if (g_render.memDC) {
+        SelectObject(g_render.memDC, g_render.oldBitmap);
+        DeleteObject(g_render.backBuffer);
+        DeleteDC(g_render.memDC);
     }
-    lockPiece();
-    clearLines();
-    spawnNewPiece();
+    g_render.memDC = nullptr;
+    g_render.backBuffer = nullptr;
+    g_render.oldBitmap = nullptr;
+    g_render.pixels = nullptr;
+    g_render.width = 0;
+    g_render.height = 0;
+}
+
+// Bufor tylny o rozmiarze obszaru klienta; nic nie robi, gdy rozmiar się zgadza
+void ensureBackBuffer(HWND hwnd, int width, int height) {
+    if (g_render.memDC && g_render.width == width && g_render.height == height)
+        return;
+    destroyBackBuffer();
+    if (width <= 0 || height <= 0)
+        return;
+
+    // 32-bitowa sekcja DIB z wierszami od góry: GDI rysuje na niej tekst,
+    // a komórki piszemy bezpośrednio do pikseli
+    BITMAPINFO bmi = { 0 };
+    bmi.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
+    bmi.bmiHeader.biWidth = width;
+    bmi.bmiHeader.biHeight = -height;
+    bmi.bmiHeader.biPlanes = 1;
+    bmi.bmiHeader.biBitCount = 32;
+    bmi.bmiHeader.biCompression = BI_RGB;
+
+    HDC hdc = GetDC(hwnd);
+    void* bits = nullptr;
+    g_render.memDC = CreateCompatibleDC(hdc);
+    g_render.backBuffer = CreateDIBSection(hdc, &bmi, DIB_RGB_COLORS, &bits, nullptr, 0);
+    g_render.oldBitmap = SelectObject(g_render.memDC, g_render.backBuffer);
+    g_render.pixels = (uint32_t*)bits;
+    g_render.width = width;
+    g_render.height = height;
+    ReleaseDC(hwnd, hdc);
 }
 
 // --- Rysowanie ---
-void drawBoard(HDC hdc, RECT clientRect) {
-    int boardPxW = BOARD_W * CELL_SIZE;
-    int boardPxH = BOARD_H * CELL_SIZE;
-
-    // tło
-    HBRUSH bg = CreateSolidBrush(RGB(20, 20, 20));
-    RECT r = { 0, 0, clientRect.right, clientRect.bottom };
-    FillRect(hdc, &r, bg);
-    DeleteObject(bg);
-
-    // przesunięcie planszy, żeby było trochę marginesu
-    int offsetX = 20;
-    int offsetY = 20;
-
-    // ramka planszy
-    HPEN borderPen = CreatePen(PS_SOLID, 2, RGB(200, 200, 200));
-    HGDIOBJ oldPen = SelectObject(hdc, borderPen);
-    Rectangle(hdc,
-              offsetX - 1, offsetY - 1,
-              offsetX + boardPxW + 1, offsetY + boardPxH + 1);
-    SelectObject(hdc, oldPen);
-    DeleteObject(borderPen);
-
-    // rysuj komórki z planszy
+
+// Unieważnia tylko to, co zgłosił silnik: w każdym wierszu zakres od
+// pierwszej do ostatniej zmienionej komórki, plus zmienione pola panelu.
+void invalidateDirty(HWND hwnd, const DirtyRegion& d) {
+    const SceneLayout& layout = g_render.layout;
     for (int y = 0; y < BOARD_H; ++y) {
-        for (int x = 0; x < BOARD_W; ++x) {
-            int v = board[y][x];
-            if (v != 0) {
-                HBRUSH b = g_brushes[v];
-                RECT cell = {
-                    offsetX + x * CELL_SIZE,
-                    offsetY + y * CELL_SIZE,
-                    offsetX + (x + 1) * CELL_SIZE,
-                    offsetY + (y + 1) * CELL_SIZE
-                };
-                FillRect(hdc, &cell, b);
-                // delikatna ramka
-                FrameRect(hdc, &cell, (HBRUSH)GetStockObject(BLACK_BRUSH));
-            }
+        uint16_t m = d.rows[y];
+        if (!m) continue;
+        int x0 = 0;
+        while (!((m >> x0) & 1)) ++x0;
+        int x1 = BOARD_W - 1;
+        while (!((m >> x1) & 1)) --x1;
+        PixelRect first = cellRect(layout, x0, y);
+        RECT r = { first.left, first.top, cellRect(layout, x1, y).right, first.bottom };
+        InvalidateRect(hwnd, &r, FALSE);
+    }
+    if (d.hud) {
+        RECT clientRect;
+        GetClientRect(hwnd, &clientRect);
+        const HudField fields[2] = { HUD_SCORE, HUD_STATUS };
+        for (HudField f : fields) {
+            if (!(d.hud & f)) continue;
+            PixelRect p = hudRect(layout, f, clientRect.right, clientRect.bottom);
+            RECT r = { p.left, p.top, p.right, p.bottom };
+            InvalidateRect(hwnd, &r, FALSE);
         }
     }
+}
 
-    // rysuj aktualny klocek
-    if (!gameOver) {
-        Block blocks[4];
-        getPieceBlocks(currentPiece, blocks);
-        HBRUSH b = g_brushes[currentPiece.shape + 1];
-        for (int i = 0; i < 4; ++i) {
-            int x = blocks[i].x;
-            int y = blocks[i].y;
-            if (y < 0) continue; // nad widocznym obszarem
-            RECT cell = {
-                offsetX + x * CELL_SIZE,
-                offsetY + y * CELL_SIZE,
-                offsetX + (x + 1) * CELL_SIZE,
-                offsetY + (y + 1) * CELL_SIZE
-            };
-            FillRect(hdc, &cell, b);
-            FrameRect(hdc, &cell, (HBRUSH)GetStockObject(BLACK_BRUSH));
-        }
+// Okno: bierze najnowszą kopię stanu i unieważnia to, co się w niej zmieniło.
+// Gdy wątek symulacji opublikował po drodze kopie, których nie widzieliśmy,
+// ich zmian nie znamy – przerysowujemy całe okno.
+void showLatestFrame(HWND hwnd) {
+    g_framePosted.store(false);
+    if (!g_frames.acquire())
+        return;
+    const FrameSnapshot& f = g_frames.front();
+    if (f.inputNs >= 0 && (g_unpaintedInputNs < 0 || f.inputNs < g_unpaintedInputNs))
+        g_unpaintedInputNs = f.inputNs;
+    if (f.seq != g_shownSeq + 1)
+        InvalidateRect(hwnd, nullptr, FALSE);
+    else
+        invalidateDirty(hwnd, f.game.dirty);
+    g_shownSeq = f.seq;
+}
+
+// --- Pomiary ---
+
+void formatOverlay(char* buf, size_t size) {
+    struct Row {
+        const char* name;
+        const LatencyHistogram* h;
+    };
+    const Row rows[] = {
+        { u8"wejście→obraz", &g_inputLatency },
+        { "tik", &g_tickTime },
+        { "rysowanie", &g_paintTime },
+    };
+    size_t n = 0;
+    for (const Row& row : rows) {
+        // krótkie wiersze – panel ma ok. 150 px szerokości
+        int len = snprintf(buf + n, size - n, "%s [ms]\n p50 %.2f  p99 %.2f\n max %.2f\n",
+                           row.name, row.h->percentile(50) / 1e6, row.h->percentile(99) / 1e6,
+                           row.h->max() / 1e6);
+        if (len < 0 || (size_t)len >= size - n)
+            break;
+        n += (size_t)len;
     }
+}
 
-    // tekst – punkty i komunikaty
-    SetBkMode(hdc, TRANSPARENT);
-    SetTextColor(hdc, RGB(220, 220, 220));
+void invalidateOverlay(HWND hwnd) {
+    RECT clientRect;
+    GetClientRect(hwnd, &clientRect);
+    PixelRect p = overlayRect(g_render.layout, clientRect.right, clientRect.bottom);
+    RECT r = { p.left, p.top, p.right, p.bottom };
+    InvalidateRect(hwnd, &r, FALSE);
+}
 
-    TCHAR buf[128];
-    wsprintf(buf, TEXT("Score: %d"), score);
-    TextOut(hdc, offsetX + boardPxW + 20, offsetY, buf, lstrlen(buf));
+void saveLatencyReport() {
+    FILE* f = fopen(LATENCY_FILE, "w");
+    if (!f)
+        return;
+    writeHistogram(f, "input_to_photon", g_inputLatency);
+    writeHistogram(f, "tick", g_tickTime);
+    writeHistogram(f, "paint", g_paintTime);
+    fclose(f);
+}
 
-    if (gameOver) {
-        const TCHAR* msg = TEXT("GAME OVER - nacisnij Enter");
-        TextOut(hdc, offsetX + boardPxW + 20, offsetY + 40, msg, lstrlen(msg));
+// Rysuje tylko wnętrze paintRect – reszta bufora tylnego zostaje z poprzednich klatek
+void drawBoard(HDC hdc, RECT paintRect) {
+    TRACE_SCOPE("drawBoard");
+    PixelRect clip = { (int)paintRect.left, (int)paintRect.top,
+                       (int)paintRect.right, (int)paintRect.bottom };
+    const GameState& game = g_frames.front().game;
+    char overlay[256];
+    if (g_overlay)
+        formatOverlay(overlay, sizeof(overlay));
+    const char* text = g_overlay ? overlay : nullptr;
+    if (g_pixelRenderer && g_render.pixels) {
+        Framebuffer fb = makeFramebuffer(g_render.pixels, g_render.width, g_render.height, g_render.width);
+        DibRenderer r(fb, g_atlas, hdc);
+        drawScene(r, game, g_render.layout, clip, g_playback, text);
     }
     else {
-        const TCHAR* help =
-            TEXT("Sterowanie:\n")
-            TEXT("←/→  - ruch\n")
-            TEXT("↓    - szybciej w dol\n")
-            TEXT("↑    - obrot\n")
-            TEXT("Spacja - hard drop");
-        TextOut(hdc, offsetX + boardPxW + 20, offsetY + 40, help, lstrlen(help));
+        GdiRenderer r(hdc);
+        drawScene(r, game, g_render.layout, clip, g_playback, text);
     }
 }
 
 // --- Okno / WinAPI ---
 
+// Nazwa przedziału śladu dla obsługi komunikatu
+const char* messageName(UINT msg) {
+    switch (msg) {
+        case WM_CREATE:     return "WM_CREATE";
+        case WM_DESTROY:    return "WM_DESTROY";
+        case WM_SIZE:       return "WM_SIZE";
+        case WM_DPICHANGED: return "WM_DPICHANGED";
+        case WM_KEYDOWN:    return "WM_KEYDOWN";
+        case WM_KEYUP:      return "WM_KEYUP";
+        case WM_KILLFOCUS:  return "WM_KILLFOCUS";
+        case WM_TIMER:      return "WM_TIMER";
+        case WM_APP_FRAME:  return "WM_APP_FRAME";
+        case WM_PAINT:      return "WM_PAINT";
+        default:            return "WndProc";
+    }
+}
+
 LRESULT CALLBACK WndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam) {
+    TRACE_SCOPE(messageName(msg));
     switch (msg) {
         case WM_CREATE: {
-            // kolory jako pędzle
-            for (int i = 0; i < 8; ++i) {
-                g_brushes[i] = CreateSolidBrush(g_colors[i]);
-            }
-            srand((unsigned int)time(nullptr));
-            resetBoard();
-            spawnNewPiece();
-            SetTimer(hwnd, ID_TIMER, TIMER_INTERVAL, nullptr);
+            // układ sceny i atlas komórek; pierwsza kopia stanu jest już gotowa
+            createRenderObjects(hwnd);
+            g_hwnd = hwnd;
+            showLatestFrame(hwnd);
             return 0;
         }
         case WM_DESTROY:
-        KillTimer(hwnd, ID_TIMER);
-        for (int i = 0; i < 8; ++i) {
-            if (g_brushes[i]) DeleteObject(g_brushes[i]);
-        }
+        g_quit = true;
+        SetEvent(g_wakeEvent);
+        if (g_simThread.joinable())
+            g_simThread.join();
+        saveLatencyReport();
+        TRACE_WRITE(TRACE_FILE);
+        destroyBackBuffer();
         PostQuitMessage(0);
         return 0;
 
-        case WM_TIMER:
-        if (wParam == ID_TIMER) {
-            if (!gameOver) {
-                movePiece(0, 1);
-            }
+        case WM_SIZE:
+        ensureBackBuffer(hwnd, LOWORD(lParam), HIWORD(lParam));
+        return 0;
+
+        case WM_DPICHANGED: {
+            // nowa grubość ramki dla nowego DPI; okno przyjmuje rozmiar zaproponowany przez system
+            createRenderObjects(hwnd);
+            const RECT* suggested = (const RECT*)lParam;
+            SetWindowPos(hwnd, nullptr, suggested->left, suggested->top,
+                         suggested->right - suggested->left, suggested->bottom - suggested->top,
+                         SWP_NOZORDER | SWP_NOACTIVATE);
             InvalidateRect(hwnd, nullptr, FALSE);
+            return 0;
         }
-        return 0;
 
         case WM_KEYDOWN:
-        if (gameOver) {
-            if (wParam == VK_RETURN) {
-                resetBoard();
-                spawnNewPiece();
-                InvalidateRect(hwnd, nullptr, TRUE);
+        if (wParam == VK_F2) {
+            g_pixelRenderer = !g_pixelRenderer;
+            InvalidateRect(hwnd, nullptr, FALSE);
+            return 0;
+        }
+        if (wParam == VK_F3) {
+            // nakładka z percentylami, odświeżana cztery razy na sekundę
+            g_overlay = !g_overlay;
+            if (g_overlay)
+                SetTimer(hwnd, OVERLAY_TIMER, 250, nullptr);
+            else
+                KillTimer(hwnd, OVERLAY_TIMER);
+            invalidateOverlay(hwnd);
+            return 0;
+        }
+        if (wParam == VK_F4) {
+            if (!g_playback)
+                g_autoplay = !g_autoplay;
+            SetEvent(g_wakeEvent);
+            return 0;
+        }
+        // Enter – nowa gra po końcu albo odtworzenie zapisu od początku
+        if (wParam == VK_RETURN) {
+            if (g_playback || g_frames.front().game.gameOver) {
+                g_restartRequested = true;
+                SetEvent(g_wakeEvent);
             }
             return 0;
         }
+        if (g_playback)
+            return 0;
 
-        switch (wParam) {
-            case VK_LEFT:
-            movePiece(-1, 0);
-            InvalidateRect(hwnd, nullptr, FALSE);
-            break;
-            case VK_RIGHT:
-            movePiece(1, 0);
-            InvalidateRect(hwnd, nullptr, FALSE);
-            break;
-            case VK_DOWN:
-            movePiece(0, 1);
-            InvalidateRect(hwnd, nullptr, FALSE);
-            break;
-            case VK_UP:
-            rotatePiece();
-            InvalidateRect(hwnd, nullptr, FALSE);
-            break;
-            case VK_SPACE:
-            hardDrop();
-            InvalidateRect(hwnd, nullptr, FALSE);
-            break;
-            default:
-            break;
+        // klawisze gry idą przez kolejkę wejścia; autopowtarzanie systemu
+        // (bit 30 lParam) pomijamy, powtórzenia liczy InputHandler
+        {
+            InputKey key;
+            if (inputKeyForVk(wParam, key) && !(lParam & (1 << 30)))
+                sendInput(key, true);
+        }
+        return 0;
+
+        case WM_KEYUP: {
+            InputKey key;
+            if (inputKeyForVk(wParam, key))
+                sendInput(key, false);
+            return 0;
         }
+
+        case WM_KILLFOCUS:
+        // puszczenia klawiszy nie dotrą do nieaktywnego okna
+        for (int k = 0; k < KEY_COUNT; ++k)
+            sendInput((InputKey)k, false);
+        return 0;
+
+        case WM_TIMER:
+        if (wParam == OVERLAY_TIMER)
+            invalidateOverlay(hwnd);
+        return 0;
+
+        case WM_APP_FRAME:
+        showLatestFrame(hwnd);
         return 0;
 
         case WM_PAINT: {
+            int64_t paintStart = clockNowNs();
             PAINTSTRUCT ps;
             HDC hdc = BeginPaint(hwnd, &ps);
 
             RECT clientRect;
             GetClientRect(hwnd, &clientRect);
 
-            // podwójne buforowanie
-            HDC memDC = CreateCompatibleDC(hdc);
-            HBITMAP memBmp = CreateCompatibleBitmap(
-                hdc, clientRect.right - clientRect.left, clientRect.bottom - clientRect.top);
-            HGDIOBJ oldBmp = SelectObject(memDC, memBmp);
-
-            drawBoard(memDC, clientRect);
-
-            BitBlt(hdc, 0, 0,
-                   clientRect.right - clientRect.left,
-                   clientRect.bottom - clientRect.top,
-                   memDC, 0, 0, SRCCOPY);
-
-            SelectObject(memDC, oldBmp);
-            DeleteObject(memBmp);
-            DeleteDC(memDC);
+            // podwójne buforowanie w stałym buforze tylnym
+            ensureBackBuffer(hwnd, clientRect.right - clientRect.left, clientRect.bottom - clientRect.top);
+            // przerysowujemy i kopiujemy tylko unieważniony obszar
+            if (g_render.memDC) {
+                drawBoard(g_render.memDC, ps.rcPaint);
+
+                BitBlt(hdc, ps.rcPaint.left, ps.rcPaint.top,
+                       ps.rcPaint.right - ps.rcPaint.left,
+                       ps.rcPaint.bottom - ps.rcPaint.top,
+                       g_render.memDC, ps.rcPaint.left, ps.rcPaint.top, SRCCOPY);
+                if (g_unpaintedInputNs >= 0) {
+                    g_inputLatency.record(clockNowNs() - g_unpaintedInputNs);
+                    g_unpaintedInputNs = -1;
+                }
+            }
 
             EndPaint(hwnd, &ps);
+            g_paintTime.record(clockNowNs() - paintStart);
             return 0;
         }
     }
@@ -384,7 +626,21 @@ int APIENTRY WinMain(HINSTANCE hInstance,
                      LPSTR     lpCmdLine,
                      int       nCmdShow) {
     (void)hPrevInstance;
-    (void)lpCmdLine;
+
+    // Game.exe plik.rpl – odtworzenie zapisanej gry
+    if (lpCmdLine && lpCmdLine[0]) {
+        char path[MAX_PATH];
+        lstrcpynA(path, lpCmdLine[0] == '"' ? lpCmdLine + 1 : lpCmdLine, MAX_PATH);
+        int len = lstrlenA(path);
+        if (len > 0 && path[len - 1] == '"')
+            path[len - 1] = 0;
+        if (!loadReplay(path, g_playbackReplay)) {
+            MessageBox(nullptr, TEXT("Nie moge wczytac zapisu gry."),
+                       TEXT("Błąd"), MB_ICONERROR | MB_OK);
+            return 0;
+        }
+        g_playback = true;
+    }
 
     const TCHAR CLASS_NAME[] = TEXT("TetrisWindowClass");
 
@@ -405,6 +661,11 @@ int APIENTRY WinMain(HINSTANCE hInstance,
         return 0;
     }
 
+    // pierwsza kopia stanu przed utworzeniem okna – WM_PAINT zawsze ma co rysować
+    g_wakeEvent = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+    startGame();
+    publishFrame();
+
     int boardPxW = BOARD_W * CELL_SIZE + 200; // miejsce na panel boczny
     int boardPxH = BOARD_H * CELL_SIZE + 100;
 
@@ -430,11 +691,19 @@ int APIENTRY WinMain(HINSTANCE hInstance,
     ShowWindow(hwnd, nCmdShow);
     UpdateWindow(hwnd);
 
-    MSG msg;
+    // Logika w osobnym wątku; 1 ms rozdzielczości zegara systemowego
+    // dla jego snu między tikami
+    TRACE_THREAD_NAME("okno");
+    timeBeginPeriod(1);
+    g_simThread = std::thread(simulationLoop);
+
+    MSG msg = { 0 };
     while (GetMessage(&msg, nullptr, 0, 0) > 0) {
         TranslateMessage(&msg);
         DispatchMessage(&msg);
     }
+    timeEndPeriod(1);
+    CloseHandle(g_wakeEvent);
 
     return (int)msg.wParam;
 }
@@ -0,0 +1,172 @@
+﻿// Rysowanie bez okna: obrazy wzorcowe i pomiar szybkości klatek.
+//
+//   RenderTool render plik.ppm (--fixture nazwa | --archive archiwum gra figura)
+//                                          – zrzut dowolnego stanu gry do PPM
+//   RenderTool golden katalog [--update]  – porównuje stany testowe z wzorcami
+//                                            katalog/nazwa.ppm (--update zapisuje nowe)
+//   RenderTool bench [--frames N]          – klatki na sekundę dla pustej, średniej
+//                                            i pełnej planszy
+//
+// Stany testowe (Engine/Fixtures.h): wzorce i pomiar używają empty (nowa gra),
+// mid (gracz losowy do połowy wysokości) i full (plansza zapełniona bez
+// pełnych wierszy); render przyjmuje każdy z nich.
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include "Archive.h"
+#include "Fixtures.h"
+#include "Image.h"
+#include "PixelRenderer.h"
+
+// Rozmiar obszaru klienta okna gry
+const int CELL_SIZE = 24;
+const int IMAGE_W = BOARD_W * CELL_SIZE + 200;
+const int IMAGE_H = BOARD_H * CELL_SIZE + 60;
+
+// stany testowe do wzorców i pomiaru klatek
+static const char* const FIXTURES[] = { "empty", "mid", "full" };
+
+struct HeadlessView {
+    CellAtlas atlas;
+    SceneLayout layout;
+    Image image;
+
+    HeadlessView() {
+        atlas.build(CELL_SIZE, PIECE_COLORS, COLOR_BOARD, COLOR_CELL_FRAME);
+        layout = makeSceneLayout(CELL_SIZE, 2);
+        image.resize(IMAGE_W, IMAGE_H);
+    }
+
+    void draw(const GameState& s, const PixelRect& clip) {
+        Framebuffer fb = image.framebuffer();
+        FramebufferRenderer r(fb, atlas);
+        drawScene(r, s, layout, clip, false);
+    }
+    void draw(const GameState& s) { draw(s, PixelRect{ 0, 0, IMAGE_W, IMAGE_H }); }
+};
+
+static int cmdRender(int argc, char** argv) {
+    if (argc < 3) {
+        fprintf(stderr, "Uzycie: render plik.ppm (--fixture nazwa | --archive archiwum gra figura)\n");
+        return 1;
+    }
+    GameState s;
+    if (!strcmp(argv[1], "--fixture")) {
+        if (!makeFixture(argv[2], s)) {
+            fprintf(stderr, "Nieznany stan testowy: %s\n", argv[2]);
+            return 1;
+        }
+    }
+    else if (!strcmp(argv[1], "--archive") && argc >= 5) {
+        ArchiveReader ar;
+        if (!ar.open(argv[2]) || !ar.seek(atoi(argv[3]), atoi(argv[4]), s)) {
+            fprintf(stderr, "%s: nie ma gry %s z figura %s\n", argv[2], argv[3], argv[4]);
+            return 1;
+        }
+    }
+    else {
+        fprintf(stderr, "Nieznany argument: %s\n", argv[1]);
+        return 1;
+    }
+
+    HeadlessView view;
+    view.draw(s);
+    if (!writePpm(argv[0], view.image)) {
+        fprintf(stderr, "%s: nie moge zapisac\n", argv[0]);
+        return 1;
+    }
+    return 0;
+}
+
+static int cmdGolden(int argc, char** argv) {
+    if (argc < 1) {
+        fprintf(stderr, "Brak katalogu z wzorcami\n");
+        return 1;
+    }
+    bool update = argc >= 2 && !strcmp(argv[1], "--update");
+
+    int failed = 0;
+    HeadlessView view;
+    for (const char* name : FIXTURES) {
+        GameState s;
+        makeFixture(name, s);
+        view.draw(s);
+
+        std::string path = std::string(argv[0]) + "/" + name + ".ppm";
+        if (update) {
+            bool ok = writePpm(path.c_str(), view.image);
+            printf("%s: %s\n", path.c_str(), ok ? "zapisany" : "BLAD ZAPISU");
+            failed += ok ? 0 : 1;
+            continue;
+        }
+        Image golden;
+        if (!readPpm(path.c_str(), golden)) {
+            printf("%s: brak wzorca\n", path.c_str());
+            ++failed;
+            continue;
+        }
+        int64_t diff = compareImages(view.image, golden);
+        printf("%s: %s (%lld roznych pikseli)\n", path.c_str(), diff == 0 ? "OK" : "ROZNY", (long long)diff);
+        if (diff != 0) {
+            std::string actual = std::string(argv[0]) + "/" + name + ".actual.ppm";
+            writePpm(actual.c_str(), view.image);
+            ++failed;
+        }
+    }
+    return failed == 0 ? 0 : 1;
+}
+
+static int cmdBench(int argc, char** argv) {
+    int frames = 2000;
+    for (int i = 0; i < argc; ++i) {
+        if (!strcmp(argv[i], "--frames") && i + 1 < argc) frames = atoi(argv[++i]);
+    }
+    if (frames <= 0)
+        return 1;
+
+    HeadlessView view;
+    printf("%-6s %12s %12s %14s\n", "plansza", "klatka [us]", "klatki/s", "ruch figury/s");
+    for (const char* name : FIXTURES) {
+        GameState s;
+        makeFixture(name, s);
+
+        // cała klatka
+        auto t0 = std::chrono::steady_clock::now();
+        for (int i = 0; i < frames; ++i)
+            view.draw(s);
+        double full = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+        // typowa klatka po ruchu: prostokąt starej i nowej pozycji figury
+        const SceneLayout& l = view.layout;
+        PixelRect moved = cellRect(l, s.currentPiece.x - 1, s.currentPiece.y);
+        moved.right += 5 * l.cellSize;
+        moved.bottom += 3 * l.cellSize;
+        t0 = std::chrono::steady_clock::now();
+        for (int i = 0; i < frames; ++i)
+            view.draw(s, moved);
+        double partial = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+        printf("%-6s %12.1f %12.0f %14.0f\n", name, full * 1e6 / frames, frames / full, frames / partial);
+    }
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    if (argc >= 2 && !strcmp(argv[1], "render"))
+        return cmdRender(argc - 2, argv + 2);
+    if (argc >= 2 && !strcmp(argv[1], "golden"))
+        return cmdGolden(argc - 2, argv + 2);
+    if (argc >= 2 && !strcmp(argv[1], "bench"))
+        return cmdBench(argc - 2, argv + 2);
+
+    fprintf(stderr,
+            "Uzycie:\n"
+            "  %s render plik.ppm (--fixture nazwa | --archive archiwum gra figura)\n"
+            "  %s golden katalog [--update]\n"
+            "  %s bench [--frames N]\n", argv[0], argv[0], argv[0]);
+    return 1;
+}
@@ -0,0 +1,43 @@
+﻿#include "Framebuffer.h"
+
+#include <algorithm>
+#include <cstring>
+
+static PixelRect intersect(const PixelRect& a, const PixelRect& b) {
+    return PixelRect{ std::max(a.left, b.left), std::max(a.top, b.top),
+                      std::min(a.right, b.right), std::min(a.bottom, b.bottom) };
+}
+
+Framebuffer makeFramebuffer(uint32_t* pixels, int width, int height, int stride) {
+    return Framebuffer{ pixels, width, height, stride, PixelRect{ 0, 0, width, height } };
+}
+
+void setClip(Framebuffer& fb, const PixelRect& r) {
+    fb.clip = intersect(r, PixelRect{ 0, 0, fb.width, fb.height });
+}
+
+void fillRect(Framebuffer& fb, const PixelRect& r, uint32_t color) {
+    PixelRect c = intersect(r, fb.clip);
+    if (c.left >= c.right)
+        return;
+    for (int y = c.top; y < c.bottom; ++y)
+        std::fill_n(fb.pixels + (size_t)y * fb.stride + c.left, c.right - c.left, color);
+}
+
+void frameRect(Framebuffer& fb, const PixelRect& r, int thickness, uint32_t color) {
+    fillRect(fb, PixelRect{ r.left, r.top, r.right, r.top + thickness }, color);
+    fillRect(fb, PixelRect{ r.left, r.bottom - thickness, r.right, r.bottom }, color);
+    fillRect(fb, PixelRect{ r.left, r.top + thickness, r.left + thickness, r.bottom - thickness }, color);
+    fillRect(fb, PixelRect{ r.right - thickness, r.top + thickness, r.right, r.bottom - thickness }, color);
+}
+
+void blitTile(Framebuffer& fb, int x, int y, const uint32_t* tile, int size) {
+    PixelRect c = intersect(PixelRect{ x, y, x + size, y + size }, fb.clip);
+    if (c.left >= c.right || c.top >= c.bottom)
+        return;
+    size_t bytes = (size_t)(c.right - c.left) * sizeof(uint32_t);
+    const uint32_t* src = tile + (size_t)(c.top - y) * size + (c.left - x);
+    uint32_t* dst = fb.pixels + (size_t)c.top * fb.stride + c.left;
+    for (int row = c.top; row < c.bottom; ++row, src += size, dst += fb.stride)
+        std::memcpy(dst, src, bytes);
+}
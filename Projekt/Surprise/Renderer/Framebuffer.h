@@ -0,0 +1,34 @@
+﻿#pragma once
+
+// Bufor pikseli 32-bitowych 0xAARRGGBB. W pamięci to bajty B, G, R, A –
+// ten sam układ co 32-bitowa sekcja DIB w Windows, więc okno rysuje prosto
+// do bitmapy, a poza Windows ten sam kod rysuje do zwykłej tablicy.
+
+#include <cstdint>
+
+constexpr uint32_t makePixel(uint8_t r, uint8_t g, uint8_t b) {
+    return 0xFF000000u | ((uint32_t)r << 16) | ((uint32_t)g << 8) | b;
+}
+
+struct PixelRect {
+    int left, top, right, bottom;   // right i bottom poza prostokątem, jak w RECT
+};
+
+// Widok na cudze piksele (sekcja DIB, std::vector); nic nie alokuje
+struct Framebuffer {
+    uint32_t* pixels;
+    int width;
+    int height;
+    int stride;         // pikseli na wiersz
+    PixelRect clip;     // poza tym prostokątem nic nie rysujemy
+};
+
+Framebuffer makeFramebuffer(uint32_t* pixels, int width, int height, int stride);
+// Zawęża obszar rysowania do r (w granicach bufora)
+void setClip(Framebuffer& fb, const PixelRect& r);
+
+void fillRect(Framebuffer& fb, const PixelRect& r, uint32_t color);
+// Ramka o danej grubości wewnątrz r
+void frameRect(Framebuffer& fb, const PixelRect& r, int thickness, uint32_t color);
+// Kopiuje kwadratowy kafel size x size wiersz po wierszu (memcpy)
+void blitTile(Framebuffer& fb, int x, int y, const uint32_t* tile, int size);
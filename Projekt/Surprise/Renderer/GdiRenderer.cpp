@@ -0,0 +1,100 @@
+﻿#include "GdiRenderer.h"
+
+#pragma comment(lib, "gdi32.lib")
+
+static COLORREF toColorRef(uint32_t c) {
+    return RGB((c >> 16) & 0xFF, (c >> 8) & 0xFF, c & 0xFF);
+}
+
+static RECT toRect(const PixelRect& r) {
+    RECT rc = { r.left, r.top, r.right, r.bottom };
+    return rc;
+}
+
+static void beginClip(HDC hdc, const PixelRect& clip) {
+    IntersectClipRect(hdc, clip.left, clip.top, clip.right, clip.bottom);
+}
+
+static void endClip(HDC hdc) {
+    SelectClipRgn(hdc, nullptr);
+}
+
+// TextOutW nie łamie wierszy – tekst z '\n' rysujemy wiersz po wierszu,
+// co wysokość czcionki
+static void drawGdiText(HDC hdc, int x, int y, const char* text, uint32_t color) {
+    TEXTMETRICW tm;
+    GetTextMetricsW(hdc, &tm);
+    int lineHeight = tm.tmHeight + tm.tmExternalLeading;
+    SetBkMode(hdc, TRANSPARENT);
+    SetTextColor(hdc, toColorRef(color));
+    for (const char* line = text;; y += lineHeight) {
+        const char* end = line;
+        while (*end && *end != '\n')
+            ++end;
+        WCHAR buf[256];
+        int len = end > line ? MultiByteToWideChar(CP_UTF8, 0, line, (int)(end - line), buf, 256) : 0;
+        if (len > 0)
+            TextOutW(hdc, x, y, buf, len);
+        if (!*end)
+            break;
+        line = end + 1;
+    }
+}
+
+// --- GdiRenderer ---
+
+void GdiRenderer::beginFrame(const PixelRect& clip) {
+    beginClip(m_hdc, clip);
+}
+
+void GdiRenderer::endFrame() {
+    endClip(m_hdc);
+}
+
+void GdiRenderer::fillRect(const PixelRect& r, uint32_t color) {
+    RECT rc = toRect(r);
+    SetDCBrushColor(m_hdc, toColorRef(color));
+    FillRect(m_hdc, &rc, (HBRUSH)GetStockObject(DC_BRUSH));
+}
+
+void GdiRenderer::frameRect(const PixelRect& r, int thickness, uint32_t color) {
+    fillRect(PixelRect{ r.left, r.top, r.right, r.top + thickness }, color);
+    fillRect(PixelRect{ r.left, r.bottom - thickness, r.right, r.bottom }, color);
+    fillRect(PixelRect{ r.left, r.top + thickness, r.left + thickness, r.bottom - thickness }, color);
+    fillRect(PixelRect{ r.right - thickness, r.top + thickness, r.right, r.bottom - thickness }, color);
+}
+
+void GdiRenderer::drawCell(const PixelRect& r, int tile) {
+    RECT rc = toRect(r);
+    HBRUSH brush = (HBRUSH)GetStockObject(DC_BRUSH);
+    if (tile >= TILE_GHOST) {
+        SetDCBrushColor(m_hdc, toColorRef(PIECE_COLORS[tile - TILE_GHOST + 1]));
+        FrameRect(m_hdc, &rc, brush);
+        return;
+    }
+    SetDCBrushColor(m_hdc, toColorRef(PIECE_COLORS[tile]));
+    FillRect(m_hdc, &rc, brush);
+    // delikatna ramka
+    SetDCBrushColor(m_hdc, toColorRef(COLOR_CELL_FRAME));
+    FrameRect(m_hdc, &rc, brush);
+}
+
+void GdiRenderer::drawText(int x, int y, const char* text, uint32_t color) {
+    drawGdiText(m_hdc, x, y, text, color);
+}
+
+// --- DibRenderer ---
+
+void DibRenderer::beginFrame(const PixelRect& clip) {
+    GdiFlush();   // GDI mogło jeszcze nie dopisać poprzednich operacji do pikseli
+    FramebufferRenderer::beginFrame(clip);
+    beginClip(m_hdc, clip);
+}
+
+void DibRenderer::endFrame() {
+    endClip(m_hdc);
+}
+
+void DibRenderer::drawText(int x, int y, const char* text, uint32_t color) {
+    drawGdiText(m_hdc, x, y, text, color);
+}
@@ -0,0 +1,40 @@
+﻿#pragma once
+
+// Backendy okna (tylko Windows): wszystko przez GDI albo komórki
+// bezpośrednio do pikseli sekcji DIB, a przez GDI tylko tekst.
+
+#include <windows.h>
+
+#include "PixelRenderer.h"
+#include "Renderer.h"
+
+// FillRect/FrameRect na każdą komórkę; kolory przez DC_BRUSH, więc bez
+// tworzenia pędzli
+class GdiRenderer : public Renderer {
+public:
+    explicit GdiRenderer(HDC hdc) : m_hdc(hdc) {}
+
+    void beginFrame(const PixelRect& clip) override;
+    void endFrame() override;
+    void fillRect(const PixelRect& r, uint32_t color) override;
+    void frameRect(const PixelRect& r, int thickness, uint32_t color) override;
+    void drawCell(const PixelRect& r, int tile) override;
+    void drawText(int x, int y, const char* text, uint32_t color) override;
+
+private:
+    HDC m_hdc;
+};
+
+// Komórki jako kafle z atlasu w pikselach sekcji DIB wybranej do hdc
+class DibRenderer : public FramebufferRenderer {
+public:
+    DibRenderer(Framebuffer& fb, const CellAtlas& atlas, HDC hdc)
+        : FramebufferRenderer(fb, atlas), m_hdc(hdc) {}
+
+    void beginFrame(const PixelRect& clip) override;
+    void endFrame() override;
+    void drawText(int x, int y, const char* text, uint32_t color) override;
+
+private:
+    HDC m_hdc;
+};
@@ -0,0 +1,61 @@
+﻿#include "Image.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+
+bool writePpm(const char* path, const Image& img) {
+    FILE* f = fopen(path, "wb");
+    if (!f)
+        return false;
+    fprintf(f, "P6\n%d %d\n255\n", img.width, img.height);
+    std::vector<uint8_t> row((size_t)img.width * 3);
+    bool ok = true;
+    for (int y = 0; y < img.height && ok; ++y) {
+        const uint32_t* src = img.pixels.data() + (size_t)y * img.width;
+        for (int x = 0; x < img.width; ++x) {
+            row[x * 3 + 0] = (uint8_t)(src[x] >> 16);
+            row[x * 3 + 1] = (uint8_t)(src[x] >> 8);
+            row[x * 3 + 2] = (uint8_t)src[x];
+        }
+        ok = fwrite(row.data(), 1, row.size(), f) == row.size();
+    }
+    return fclose(f) == 0 && ok;
+}
+
+bool readPpm(const char* path, Image& img) {
+    FILE* f = fopen(path, "rb");
+    if (!f)
+        return false;
+    int w = 0, h = 0, maxval = 0;
+    bool ok = fscanf(f, "P6 %d %d %d", &w, &h, &maxval) == 3 && fgetc(f) != EOF &&
+              w > 0 && h > 0 && maxval == 255;
+    if (ok) {
+        img.resize(w, h);
+        std::vector<uint8_t> row((size_t)w * 3);
+        for (int y = 0; y < h && ok; ++y) {
+            ok = fread(row.data(), 1, row.size(), f) == row.size();
+            uint32_t* dst = img.pixels.data() + (size_t)y * w;
+            for (int x = 0; x < w && ok; ++x)
+                dst[x] = makePixel(row[x * 3 + 0], row[x * 3 + 1], row[x * 3 + 2]);
+        }
+    }
+    fclose(f);
+    return ok;
+}
+
+int64_t compareImages(const Image& a, const Image& b, int tolerance) {
+    if (a.width != b.width || a.height != b.height)
+        return (int64_t)std::max(a.pixels.size(), b.pixels.size());
+    int64_t diff = 0;
+    for (size_t i = 0; i < a.pixels.size(); ++i) {
+        uint32_t p = a.pixels[i], q = b.pixels[i];
+        for (int shift = 0; shift < 24; shift += 8) {
+            if (std::abs((int)((p >> shift) & 0xFF) - (int)((q >> shift) & 0xFF)) > tolerance) {
+                ++diff;
+                break;
+            }
+        }
+    }
+    return diff;
+}
@@ -0,0 +1,31 @@
+﻿#pragma once
+
+// Obraz w pamięci i pliki PPM (P6) – obrazy wzorcowe do porównań
+// i zrzuty klatek bez okna.
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Framebuffer.h"
+
+struct Image {
+    int width = 0;
+    int height = 0;
+    std::vector<uint32_t> pixels;   // 0xAARRGGBB, wiersze od góry
+
+    void resize(int w, int h) {
+        width = w;
+        height = h;
+        pixels.assign((size_t)w * h, 0xFF000000u);
+    }
+    Framebuffer framebuffer() { return makeFramebuffer(pixels.data(), width, height, width); }
+};
+
+// Kanał alfa jest pomijany
+bool writePpm(const char* path, const Image& img);
+bool readPpm(const char* path, Image& img);
+
+// Liczba pikseli, w których któryś kanał różni się o więcej niż tolerance.
+// Obrazy o różnych rozmiarach różnią się wszystkimi pikselami.
+int64_t compareImages(const Image& a, const Image& b, int tolerance = 0);
@@ -0,0 +1,20 @@
+﻿#include "PixelRenderer.h"
+
+void CellAtlas::build(int cellSize, const uint32_t colors[8], uint32_t empty, uint32_t frame) {
+    m_cellSize = cellSize;
+    m_pixels.assign((size_t)TILE_COUNT * cellSize * cellSize, empty);
+
+    // kafle w tym samym buforze, więc rysowanie kafla to zwykłe memcpy wierszy
+    for (int i = 0; i < TILE_COUNT; ++i) {
+        Framebuffer fb = makeFramebuffer(m_pixels.data() + (size_t)i * cellSize * cellSize,
+                                         cellSize, cellSize, cellSize);
+        PixelRect all = { 0, 0, cellSize, cellSize };
+        if (i >= 1 && i <= 7) {
+            fillRect(fb, all, colors[i]);
+            frameRect(fb, all, 1, frame);
+        }
+        else if (i >= TILE_GHOST) {
+            frameRect(fb, all, 1, colors[i - TILE_GHOST + 1]);
+        }
+    }
+}
@@ -0,0 +1,47 @@
+﻿#pragma once
+
+// Rysowanie do bufora pikseli bez GDI: każda komórka to gotowy kafel
+// z atlasu (kolor z ramką już w pikselach), kopiowany wierszami do bufora.
+
+#include <cstdint>
+#include <vector>
+
+#include "Framebuffer.h"
+#include "Renderer.h"
+
+class CellAtlas {
+public:
+    // colors[1..7] – kolory figur; empty – wnętrze planszy; frame – ramka komórki
+    void build(int cellSize, const uint32_t colors[8], uint32_t empty, uint32_t frame);
+
+    int cellSize() const { return m_cellSize; }
+    const uint32_t* tile(int index) const {
+        return m_pixels.data() + (size_t)index * m_cellSize * m_cellSize;
+    }
+
+private:
+    std::vector<uint32_t> m_pixels;
+    int m_cellSize = 0;
+};
+
+// Backend piszący do cudzego bufora (sekcja DIB, Image). Tekstu nie
+// rysuje – nie ma własnych fontów; okno dorysowuje go przez GDI.
+class FramebufferRenderer : public Renderer {
+public:
+    FramebufferRenderer(Framebuffer& fb, const CellAtlas& atlas) : m_fb(fb), m_atlas(atlas) {}
+
+    void beginFrame(const PixelRect& clip) override { setClip(m_fb, clip); }
+    void endFrame() override {}
+    void fillRect(const PixelRect& r, uint32_t color) override { ::fillRect(m_fb, r, color); }
+    void frameRect(const PixelRect& r, int thickness, uint32_t color) override {
+        ::frameRect(m_fb, r, thickness, color);
+    }
+    void drawCell(const PixelRect& r, int tile) override {
+        blitTile(m_fb, r.left, r.top, m_atlas.tile(tile), m_atlas.cellSize());
+    }
+    void drawText(int, int, const char*, uint32_t) override {}
+
+protected:
+    Framebuffer& m_fb;
+    const CellAtlas& m_atlas;
+};
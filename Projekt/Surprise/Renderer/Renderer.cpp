@@ -0,0 +1,108 @@
+﻿#include "Renderer.h"
+
+#include <algorithm>
+#include <cstdio>
+
+SceneLayout makeSceneLayout(int cellSize, int border) {
+    SceneLayout l;
+    l.left = 20;
+    l.top = 20;
+    l.cellSize = cellSize;
+    l.border = border;
+    l.panelLeft = l.left + BOARD_W * cellSize + 20;
+    l.lineHeight = 20;
+    return l;
+}
+
+PixelRect cellRect(const SceneLayout& layout, int x, int y) {
+    return PixelRect{
+        layout.left + x * layout.cellSize,
+        layout.top + y * layout.cellSize,
+        layout.left + (x + 1) * layout.cellSize,
+        layout.top + (y + 1) * layout.cellSize
+    };
+}
+
+// komunikaty panelu mają najwyżej 6 wierszy, nakładka zaczyna się pod nimi
+static int overlayTop(const SceneLayout& layout) {
+    return layout.top + 9 * layout.lineHeight;
+}
+
+PixelRect hudRect(const SceneLayout& layout, HudField field, int width, int height) {
+    (void)height;
+    if (field == HUD_STATUS)
+        return PixelRect{ layout.panelLeft, layout.top + 2 * layout.lineHeight, width, overlayTop(layout) };
+    return PixelRect{ layout.panelLeft, layout.top, width, layout.top + layout.lineHeight };
+}
+
+PixelRect overlayRect(const SceneLayout& layout, int width, int height) {
+    return PixelRect{ layout.panelLeft, overlayTop(layout), width, height };
+}
+
+void drawScene(Renderer& r, const GameState& s, const SceneLayout& layout,
+               const PixelRect& clip, bool playback, const char* overlay) {
+    const int cs = layout.cellSize;
+    const PixelRect board = { layout.left, layout.top,
+                              layout.left + BOARD_W * cs, layout.top + BOARD_H * cs };
+
+    r.beginFrame(clip);
+
+    // tło, ramka i wnętrze planszy
+    r.fillRect(clip, COLOR_BACKGROUND);
+    r.frameRect(PixelRect{ board.left - layout.border, board.top - layout.border,
+                           board.right + layout.border, board.bottom + layout.border },
+                layout.border, COLOR_BORDER);
+    r.fillRect(board, COLOR_BOARD);
+
+    // komórki planszy – tylko te, które przecinają clip
+    if (clip.right > board.left && clip.bottom > board.top) {
+        int x0 = std::max(0, (clip.left - board.left) / cs);
+        int y0 = std::max(0, (clip.top - board.top) / cs);
+        int x1 = std::min(BOARD_W - 1, (clip.right - 1 - board.left) / cs);
+        int y1 = std::min(BOARD_H - 1, (clip.bottom - 1 - board.top) / cs);
+        for (int y = y0; y <= y1; ++y) {
+            for (int x = x0; x <= x1; ++x) {
+                int v = cellColor(s.board, x, y);
+                if (v != 0)
+                    r.drawCell(cellRect(layout, x, y), v);
+            }
+        }
+    }
+
+    if (!s.gameOver) {
+        // "duch" – miejsce, w którym klocek wyląduje
+        Block blocks[4];
+        getPieceBlocks(ghostPiece(s), blocks);
+        for (int i = 0; i < 4; ++i) {
+            if (blocks[i].y < 0) continue;
+            r.drawCell(cellRect(layout, blocks[i].x, blocks[i].y), TILE_GHOST + s.currentPiece.shape);
+        }
+
+        // aktualny klocek
+        getPieceBlocks(s.currentPiece, blocks);
+        for (int i = 0; i < 4; ++i) {
+            if (blocks[i].y < 0) continue; // nad widocznym obszarem
+            r.drawCell(cellRect(layout, blocks[i].x, blocks[i].y), s.currentPiece.shape + 1);
+        }
+    }
+
+    // tekst – punkty i komunikaty, gdy panel jest w clip
+    if (clip.right > layout.panelLeft) {
+        char buf[64];
+        snprintf(buf, sizeof(buf), "Score: %d   Level: %d", s.score, s.level);
+        r.drawText(layout.panelLeft, layout.top, buf, COLOR_TEXT);
+
+        if (playback)
+            r.drawText(layout.panelLeft, layout.top + layout.lineHeight, "Odtwarzanie zapisu", COLOR_TEXT);
+
+        const char* status = s.gameOver
+            ? "GAME OVER - nacisnij Enter"
+            : u8"Sterowanie:\n←/→  - ruch\n↓    - szybciej w dol\n↑    - obrot\nSpacja - hard drop\nF4   - autopilot";
+        r.drawText(layout.panelLeft, layout.top + 2 * layout.lineHeight, status, COLOR_TEXT);
+
+        if (overlay)
+            r.drawText(layout.panelLeft, overlayTop(layout), overlay, COLOR_TEXT);
+    }
+
+    r.endFrame();
+}
@@ -0,0 +1,72 @@
+﻿#pragma once
+
+// Scena gry niezależna od sposobu rysowania: plansza, duch, figura
+// i panel boczny opisane raz w drawScene, a backend (GDI, sekcja DIB,
+// bufor w pamięci) tylko wypełnia prostokąty, kafle komórek i tekst.
+
+#include <cstdint>
+
+#include "Engine.h"
+#include "Framebuffer.h"
+
+// Kolory figur 1..7 (0 – nieużywany)
+inline constexpr uint32_t PIECE_COLORS[8] = {
+    makePixel(0, 0, 0),
+    makePixel(0, 255, 255),     // I
+    makePixel(0, 0, 255),       // J
+    makePixel(255, 165, 0),     // L (pomarańczowy)
+    makePixel(255, 255, 0),     // O
+    makePixel(0, 255, 0),       // S
+    makePixel(160, 32, 240),    // T (fiolet)
+    makePixel(255, 0, 0),       // Z
+};
+
+const uint32_t COLOR_BACKGROUND = makePixel(20, 20, 20);
+const uint32_t COLOR_BOARD      = makePixel(255, 255, 255);   // wnętrze planszy
+const uint32_t COLOR_BORDER     = makePixel(200, 200, 200);
+const uint32_t COLOR_CELL_FRAME = makePixel(0, 0, 0);
+const uint32_t COLOR_TEXT       = makePixel(220, 220, 220);
+
+// Rodzaje komórek: figury 1..7 i ich "duchy"
+const int TILE_EMPTY = 0;
+const int TILE_GHOST = 8;       // TILE_GHOST + kształt 0..6
+const int TILE_COUNT = TILE_GHOST + 7;
+
+// Położenie elementów sceny w pikselach
+struct SceneLayout {
+    int left;           // lewy górny róg planszy
+    int top;
+    int cellSize;
+    int border;         // grubość ramki planszy
+    int panelLeft;      // początek panelu bocznego
+    int lineHeight;     // odstęp wierszy tekstu w panelu
+};
+
+SceneLayout makeSceneLayout(int cellSize, int border);
+PixelRect cellRect(const SceneLayout& layout, int x, int y);
+// Pasek panelu z danym polem, od panelLeft do prawej krawędzi obrazu
+PixelRect hudRect(const SceneLayout& layout, HudField field, int width, int height);
+// Nakładka diagnostyczna pod komunikatami panelu, do dołu obrazu
+PixelRect overlayRect(const SceneLayout& layout, int width, int height);
+
+class Renderer {
+public:
+    virtual ~Renderer() = default;
+
+    // Wszystko między beginFrame a endFrame jest obcinane do clip
+    virtual void beginFrame(const PixelRect& clip) = 0;
+    virtual void endFrame() = 0;
+
+    virtual void fillRect(const PixelRect& r, uint32_t color) = 0;
+    // Ramka o danej grubości wewnątrz r
+    virtual void frameRect(const PixelRect& r, int thickness, uint32_t color) = 0;
+    // Komórka planszy rodzaju tile (TILE_*) w prostokącie r
+    virtual void drawCell(const PixelRect& r, int tile) = 0;
+    // Tekst w UTF-8, (x, y) – lewy górny róg
+    virtual void drawText(int x, int y, const char* text, uint32_t color) = 0;
+};
+
+// Rysuje stan gry w obszarze clip; playback – czy pokazać napis o odtwarzaniu,
+// overlay – tekst nakładki diagnostycznej (nullptr – bez nakładki)
+void drawScene(Renderer& r, const GameState& s, const SceneLayout& layout,
+               const PixelRect& clip, bool playback, const char* overlay = nullptr);
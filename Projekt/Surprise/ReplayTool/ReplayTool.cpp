@@ -0,0 +1,229 @@
+﻿// Narzędzie do zapisów gier.
+//
+//   ReplayTool verify plik...                      – odtwarza gry bez okna i sprawdza wynik
+//   ReplayTool record plik [--seed S] [--bag]      – nagrywa grę gracza losowego (do testów)
+//   ReplayTool pack archiwum [--interval K] [--random N --seed S] plik...
+//                                                  – pakuje zapisy do archiwum z klatkami kluczowymi
+//   ReplayTool stats archiwum                      – statystyki całego archiwum (mmap, strumieniowo)
+//   ReplayTool seek archiwum gra figura            – stan gry przy danej figurze
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "Archive.h"
+#include "Replay.h"
+
+static int cmdVerify(int argc, char** argv) {
+    int failed = 0;
+    for (int i = 0; i < argc; ++i) {
+        Replay r;
+        if (!loadReplay(argv[i], r)) {
+            fprintf(stderr, "%s: nie moge wczytac\n", argv[i]);
+            ++failed;
+            continue;
+        }
+
+        GameState s;
+        auto t0 = std::chrono::steady_clock::now();
+        bool ok = verifyReplay(r, &s);
+        double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count();
+
+        printf("%s: %s  wynik %d/%d  linie %d  figury %d  zdarzenia %u  %zu B (%.2f B/figure)  %.0f us\n",
+               argv[i], ok ? "OK" : "NIEZGODNY", s.score, r.score, s.lines, s.pieces,
+               r.eventCount, r.data.size(), r.pieces > 0 ? (double)r.data.size() / r.pieces : 0.0, us);
+        if (!ok)
+            ++failed;
+    }
+    return failed == 0 ? 0 : 1;
+}
+
+// Gracz losowy jak w symulatorze; akcja co 100 ms, między nimi grawitacja
+static Replay recordRandomGame(uint64_t seed, Randomizer randomizer) {
+    GameState s;
+    resetBoard(s, seed, randomizer);
+    spawnNewPiece(s);
+    ReplayRecorder rec;
+    rec.begin(seed, randomizer);
+
+    Rng player = s.rng;
+    rngJump(player);
+    uint32_t time = 0;
+    while (!s.gameOver) {
+        uint32_t r = nextU32(player);
+        Action a = (Action)(ACT_LEFT + r % (ACT_COUNT - ACT_LEFT));
+        time += TICKS_PER_SECOND / 10;
+        runTicks(s, time);
+        if (s.gameOver)
+            break;
+        rec.record(time, a);
+        applyAction(s, a);
+    }
+    rec.finish(s);
+    return rec.replay();
+}
+
+static int cmdRecord(int argc, char** argv) {
+    if (argc < 1) {
+        fprintf(stderr, "Brak nazwy pliku\n");
+        return 1;
+    }
+    const char* path = argv[0];
+    uint64_t seed = 1;
+    Randomizer randomizer = RANDOMIZER_UNIFORM;
+    for (int i = 1; i < argc; ++i) {
+        if (!strcmp(argv[i], "--seed") && i + 1 < argc) seed = strtoull(argv[++i], nullptr, 10);
+        else if (!strcmp(argv[i], "--bag"))             randomizer = RANDOMIZER_BAG7;
+    }
+
+    Replay r = recordRandomGame(seed, randomizer);
+    if (!saveReplay(path, r)) {
+        fprintf(stderr, "%s: nie moge zapisac\n", path);
+        return 1;
+    }
+    printf("%s: wynik %d  figury %d  zdarzenia %u\n", path, r.score, r.pieces, r.eventCount);
+    return 0;
+}
+
+static int cmdPack(int argc, char** argv) {
+    if (argc < 1) {
+        fprintf(stderr, "Brak nazwy archiwum\n");
+        return 1;
+    }
+    const char* path = argv[0];
+    int interval = KEYFRAME_INTERVAL;
+    int randomGames = 0;
+    uint64_t seed = 1;
+    std::vector<Replay> replays;
+    for (int i = 1; i < argc; ++i) {
+        if (!strcmp(argv[i], "--interval") && i + 1 < argc)    interval = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--random") && i + 1 < argc) randomGames = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--seed") && i + 1 < argc)   seed = strtoull(argv[++i], nullptr, 10);
+        else {
+            Replay r;
+            if (!loadReplay(argv[i], r)) {
+                fprintf(stderr, "%s: nie moge wczytac\n", argv[i]);
+                return 1;
+            }
+            replays.push_back(std::move(r));
+        }
+    }
+    for (int i = 0; i < randomGames; ++i)
+        replays.push_back(recordRandomGame(deriveSeed(seed, (uint64_t)i), RANDOMIZER_UNIFORM));
+
+    if (!writeArchive(path, replays, interval)) {
+        fprintf(stderr, "%s: nie moge zapisac\n", path);
+        return 1;
+    }
+    printf("%s: %zu gier, klatka co %d figur\n", path, replays.size(), interval);
+    return 0;
+}
+
+static int cmdStats(int argc, char** argv) {
+    ArchiveReader ar;
+    if (argc < 1 || !ar.open(argv[0])) {
+        fprintf(stderr, "Nie moge otworzyc archiwum\n");
+        return 1;
+    }
+
+    auto t0 = std::chrono::steady_clock::now();
+    int64_t score = 0, lines = 0, pieces = 0, events = 0, bytes = 0, keyframes = 0;
+    int64_t actions[ACT_COUNT] = { 0 };
+    int best = -1;
+    for (int i = 0; i < ar.replayCount(); ++i) {
+        ArchiveEntry e = ar.entry(i);
+        score += e.score;
+        lines += e.lines;
+        pieces += e.pieces;
+        keyframes += e.keyframeCount;
+        if (best < 0 || e.score > ar.entry(best).score)
+            best = i;
+
+        // zdarzenia czytane prosto ze zmapowanego pliku
+        ReplayView v;
+        if (!ar.replay(i, v))
+            continue;
+        bytes += (int64_t)v.size;
+        ReplayReader reader(v);
+        ReplayEvent ev;
+        while (reader.next(ev)) {
+            ++actions[ev.action];
+            ++events;
+        }
+    }
+    double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    int n = ar.replayCount();
+    printf("gry: %d  figury: %lld  linie: %lld  klatki kluczowe: %lld\n",
+           n, (long long)pieces, (long long)lines, (long long)keyframes);
+    if (n > 0) {
+        printf("sr. wynik: %.1f  najlepsza gra: %d (%d pkt)\n",
+               (double)score / n, best, ar.entry(best).score);
+    }
+    printf("zdarzenia: %lld (%.2f B/figure)  lewo %lld  prawo %lld  dol %lld  obrot %lld  zrzut %lld\n",
+           (long long)events, pieces > 0 ? (double)bytes / pieces : 0.0,
+           (long long)actions[ACT_LEFT], (long long)actions[ACT_RIGHT], (long long)actions[ACT_DOWN],
+           (long long)actions[ACT_ROTATE], (long long)actions[ACT_HARD_DROP]);
+    printf("czas skanowania: %.3f s (%.0f zdarzen/s)\n", secs, secs > 0 ? events / secs : 0.0);
+    return 0;
+}
+
+static void printBoard(const GameState& s) {
+    Block blocks[4];
+    getPieceBlocks(s.currentPiece, blocks);
+    for (int y = 0; y < BOARD_H; ++y) {
+        putchar('|');
+        for (int x = 0; x < BOARD_W; ++x) {
+            bool piece = false;
+            for (int i = 0; i < 4; ++i)
+                piece = piece || (blocks[i].x == x && blocks[i].y == y);
+            putchar(piece ? '@' : isCellFilled(s.board, x, y) ? '#' : '.');
+        }
+        printf("|\n");
+    }
+}
+
+static int cmdSeek(int argc, char** argv) {
+    ArchiveReader ar;
+    if (argc < 3 || !ar.open(argv[0])) {
+        fprintf(stderr, "Uzycie: seek archiwum gra figura\n");
+        return 1;
+    }
+    int game = atoi(argv[1]);
+    int piece = atoi(argv[2]);
+
+    GameState s;
+    auto t0 = std::chrono::steady_clock::now();
+    bool ok = ar.seek(game, piece, s);
+    double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count();
+    if (!ok) {
+        fprintf(stderr, "Gra %d nie ma figury %d\n", game, piece);
+        return 1;
+    }
+    printBoard(s);
+    printf("figura %d  wynik %d  linie %d  (%.1f us)\n", s.pieces, s.score, s.lines, us);
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    if (argc >= 2 && !strcmp(argv[1], "verify"))
+        return cmdVerify(argc - 2, argv + 2);
+    if (argc >= 2 && !strcmp(argv[1], "record"))
+        return cmdRecord(argc - 2, argv + 2);
+    if (argc >= 2 && !strcmp(argv[1], "pack"))
+        return cmdPack(argc - 2, argv + 2);
+    if (argc >= 2 && !strcmp(argv[1], "stats"))
+        return cmdStats(argc - 2, argv + 2);
+    if (argc >= 2 && !strcmp(argv[1], "seek"))
+        return cmdSeek(argc - 2, argv + 2);
+
+    fprintf(stderr,
+            "Uzycie:\n"
+            "  %s verify plik...\n"
+            "  %s record plik [--seed S] [--bag]\n"
+            "  %s pack archiwum [--interval K] [--random N --seed S] plik...\n"
+            "  %s stats archiwum\n"
+            "  %s seek archiwum gra figura\n", argv[0], argv[0], argv[0], argv[0], argv[0]);
+    return 1;
+}
@@ -0,0 +1,189 @@
+﻿// Symulator wsadowy: rozgrywa wiele całych gier bez okna na wszystkich
+// rdzeniach i zapisuje wynik każdej gry do wcześniej zaalokowanej tablicy.
+//
+//   Simulator [--games N] [--threads T] [--seed S] [--max-pieces P] [--bag] [--csv plik]
+//             [--bot [--depth D] [--beam W] [--tt-bits B]]
+//
+// Domyślnie gra gracz losowy; --bot włącza bota z przeszukiwaniem wiązką
+// (D figur w przód, W plansz na poziomie). Boty wszystkich wątków dzielą
+// tablicę transpozycji z 2^B wpisami (B = 0 wyłącza).
+//
+// Gra nr i startuje z ziarna deriveSeed(S, i), więc wyniki nie zależą
+// od liczby wątków i każdą grę da się odtworzyć osobno.
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include "Bot.h"
+#include "Engine.h"
+#include "ThreadPool.h"
+
+struct SimConfig {
+    int games = 100000;
+    int threads = 0;            // 0 = wszystkie rdzenie
+    uint64_t seed = 1;
+    Randomizer randomizer = RANDOMIZER_UNIFORM;
+    int maxPieces = 100000;     // limit długości jednej gry
+    const char* csvPath = nullptr;
+    bool bot = false;
+    BotConfig botConfig;
+    int tableBits = 20;
+};
+
+// Wynik jednej gry
+struct GameResult {
+    int score;
+    int lines;
+    int pieces;
+    int64_t actions;    // długość gry w akcjach
+    int64_t evaluated;  // bot: plansze ocenione
+    int64_t cacheHits;  // bot: oceny wzięte z tablicy transpozycji
+};
+
+static bool parseArgs(int argc, char** argv, SimConfig& cfg) {
+    for (int i = 1; i < argc; ++i) {
+        const char* a = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (!strcmp(a, "--games") && hasValue)           cfg.games = atoi(argv[++i]);
+        else if (!strcmp(a, "--threads") && hasValue)    cfg.threads = atoi(argv[++i]);
+        else if (!strcmp(a, "--seed") && hasValue)       cfg.seed = strtoull(argv[++i], nullptr, 10);
+        else if (!strcmp(a, "--max-pieces") && hasValue) cfg.maxPieces = atoi(argv[++i]);
+        else if (!strcmp(a, "--csv") && hasValue)        cfg.csvPath = argv[++i];
+        else if (!strcmp(a, "--bag"))                    cfg.randomizer = RANDOMIZER_BAG7;
+        else if (!strcmp(a, "--bot"))                    cfg.bot = true;
+        else if (!strcmp(a, "--depth") && hasValue)      cfg.botConfig.depth = atoi(argv[++i]);
+        else if (!strcmp(a, "--beam") && hasValue)       cfg.botConfig.beamWidth = atoi(argv[++i]);
+        else if (!strcmp(a, "--tt-bits") && hasValue)    cfg.tableBits = atoi(argv[++i]);
+        else {
+            fprintf(stderr, "Nieznany argument: %s\n", a);
+            return false;
+        }
+    }
+    return cfg.games > 0 && cfg.maxPieces > 0 && cfg.tableBits >= 0 && cfg.tableBits <= 30;
+}
+
+// Gracz losowy: dla każdej figury losowy obrót i przesunięcie, potem hard drop
+static GameResult playGame(const SimConfig& cfg, int index) {
+    Action actions[16];
+
+    GameState s;
+    resetBoard(s, deriveSeed(cfg.seed, (uint64_t)index), cfg.randomizer);
+    spawnNewPiece(s);
+
+    // osobny strumień dla decyzji gracza, żeby nie zmieniać kolejności figur
+    Rng player = s.rng;
+    rngJump(player);
+    int64_t total = 0;
+    while (!s.gameOver && s.pieces < cfg.maxPieces) {
+        uint32_t r = nextU32(player);
+        int rot = r & 3;
+        int dx = (int)((r >> 8) % BOARD_W) - BOARD_W / 2;
+        int n = 0;
+        for (int i = 0; i < rot; ++i)
+            actions[n++] = ACT_ROTATE;
+        for (int i = 0; i < (dx < 0 ? -dx : dx); ++i)
+            actions[n++] = dx < 0 ? ACT_LEFT : ACT_RIGHT;
+        actions[n++] = ACT_HARD_DROP;
+        total += step(s, actions, n);
+    }
+    return GameResult{ s.score, s.lines, s.pieces, total, 0, 0 };
+}
+
+// Bot: dla każdej figury droga do najlepszego położenia
+static GameResult playBotGame(const SimConfig& cfg, int index, Bot& bot) {
+    Action actions[64];
+
+    GameState s;
+    resetBoard(s, deriveSeed(cfg.seed, (uint64_t)index), cfg.randomizer);
+    spawnNewPiece(s);
+
+    int64_t total = 0, evaluated = 0, cacheHits = 0;
+    while (!s.gameOver && s.pieces < cfg.maxPieces) {
+        int n = bot.think(s, actions, 64);
+        evaluated += bot.evaluated();
+        cacheHits += bot.cacheHits();
+        if (n == 0) {
+            // figura nie ma gdzie wylądować – zrzut tam, gdzie stoi
+            actions[0] = ACT_HARD_DROP;
+            n = 1;
+        }
+        total += step(s, actions, n);
+    }
+    return GameResult{ s.score, s.lines, s.pieces, total, evaluated, cacheHits };
+}
+
+static void writeCsv(const char* path, const std::vector<GameResult>& results) {
+    FILE* f = fopen(path, "w");
+    if (!f) {
+        fprintf(stderr, "Nie moge zapisac %s\n", path);
+        return;
+    }
+    fprintf(f, "game,score,lines,pieces,actions\n");
+    for (size_t i = 0; i < results.size(); ++i) {
+        const GameResult& g = results[i];
+        fprintf(f, "%zu,%d,%d,%d,%lld\n", i, g.score, g.lines, g.pieces, (long long)g.actions);
+    }
+    fclose(f);
+}
+
+int main(int argc, char** argv) {
+    SimConfig cfg;
+    if (!parseArgs(argc, argv, cfg)) {
+        fprintf(stderr, "Uzycie: %s [--games N] [--threads T] [--seed S] [--max-pieces P] [--bag] [--csv plik]\n"
+                        "          [--bot [--depth D] [--beam W] [--tt-bits B]]\n", argv[0]);
+        return 1;
+    }
+
+    std::vector<GameResult> results(cfg.games);
+    ThreadPool pool(cfg.threads);
+
+    // bot na wątek – bufory przeszukiwania nie są współdzielone, tablica
+    // transpozycji tak
+    std::unique_ptr<TranspositionTable> table;
+    std::vector<std::unique_ptr<Bot>> bots;
+    if (cfg.bot) {
+        if (cfg.tableBits > 0) {
+            table.reset(new TranspositionTable(cfg.tableBits));
+            cfg.botConfig.table = table.get();
+        }
+        for (int i = 0; i < pool.threadCount(); ++i)
+            bots.emplace_back(new Bot(cfg.botConfig));
+    }
+
+    auto t0 = std::chrono::steady_clock::now();
+    pool.parallelFor(cfg.games, [&](int index, int worker) {
+        results[index] = cfg.bot ? playBotGame(cfg, index, *bots[worker]) : playGame(cfg, index);
+    });
+    double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    int64_t score = 0, lines = 0, pieces = 0, actions = 0, evaluated = 0, cacheHits = 0;
+    for (const GameResult& g : results) {
+        score += g.score;
+        lines += g.lines;
+        pieces += g.pieces;
+        actions += g.actions;
+        evaluated += g.evaluated;
+        cacheHits += g.cacheHits;
+    }
+
+    printf("gry:        %d (watki: %d)\n", cfg.games, pool.threadCount());
+    printf("czas:       %.3f s\n", secs);
+    printf("gry/s:      %.0f\n", cfg.games / secs);
+    printf("figury/s:   %.0f\n", pieces / secs);
+    printf("akcje/s:    %.0f\n", actions / secs);
+    printf("sr. wynik:  %.1f  sr. linie: %.2f  sr. figury: %.1f\n",
+           (double)score / cfg.games, (double)lines / cfg.games, (double)pieces / cfg.games);
+    if (cfg.bot) {
+        int64_t lookups = evaluated + cacheHits;
+        printf("oceny:      %.1f na figure, z tablicy %.1f%%\n",
+               pieces > 0 ? (double)evaluated / pieces : 0.0, lookups > 0 ? 100.0 * cacheHits / lookups : 0.0);
+    }
+
+    if (cfg.csvPath)
+        writeCsv(cfg.csvPath, results);
+    return 0;
+}
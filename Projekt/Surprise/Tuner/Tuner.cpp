@@ -0,0 +1,344 @@
+﻿// Strojenie wag oceny bota algorytmem genetycznym. Każdy kandydat (zestaw
+// EvalWeights) rozgrywa te same gry bez okna – wszystkie rdzenie, ziarna
+// ustalone dla pokolenia – a jego oceną jest średnia liczba linii.
+//
+//   Tuner [--population P] [--games G] [--generations N] [--max-pieces M]
+//         [--depth D] [--beam W] [--threads T] [--seed S]
+//         [--checkpoint plik] [--resume]
+//
+// Po każdym pokoleniu populacja trafia do pliku kontrolnego (domyślnie
+// tuner.txt); --resume wczytuje go i liczy dalej od zapisanego pokolenia.
+// Ziarno, liczba gier i figur oraz ustawienia bota pochodzą wtedy z pliku,
+// a nie z linii poleceń – inne dałyby inną funkcję oceny.
+// Pokolenie g gra ziarnami deriveSeed(S, g * G + i), a losowanie operatorów
+// genetycznych ma ziarno deriveSeed(S, g), więc wznowiony przebieg daje te
+// same wyniki co nieprzerwany.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "Bot.h"
+#include "Engine.h"
+#include "ThreadPool.h"
+
+const int ELITE = 2;            // najlepsi przechodzą bez zmian
+const int TOURNAMENT = 3;       // rozmiar turnieju przy wyborze rodzica
+const float MUTATION_RATE = 0.3f;
+const float MUTATION_SIGMA = 0.2f;
+
+struct TunerConfig {
+    int population = 32;
+    int games = 8;              // gier na kandydata w pokoleniu
+    int generations = 50;       // łącznie, razem z pokoleniami sprzed wznowienia
+    int maxPieces = 500;
+    int threads = 0;
+    uint64_t seed = 1;
+    BotConfig botConfig;
+    const char* checkpoint = "tuner.txt";
+    bool resume = false;
+};
+
+struct Candidate {
+    EvalWeights weights;
+    double fitness = 0;
+};
+
+// Stan zapisywany w pliku kontrolnym
+struct TunerState {
+    int generation = 0;         // następne pokolenie do oceny
+    std::vector<Candidate> population;
+    Candidate best;             // najlepszy dotąd (fitness z jego pokolenia)
+    bool hasBest = false;
+};
+
+static bool parseArgs(int argc, char** argv, TunerConfig& cfg) {
+    cfg.botConfig.depth = 1;
+    cfg.botConfig.beamWidth = 1;
+    for (int i = 1; i < argc; ++i) {
+        const char* a = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (!strcmp(a, "--population") && hasValue)       cfg.population = atoi(argv[++i]);
+        else if (!strcmp(a, "--games") && hasValue)       cfg.games = atoi(argv[++i]);
+        else if (!strcmp(a, "--generations") && hasValue) cfg.generations = atoi(argv[++i]);
+        else if (!strcmp(a, "--max-pieces") && hasValue)  cfg.maxPieces = atoi(argv[++i]);
+        else if (!strcmp(a, "--depth") && hasValue)       cfg.botConfig.depth = atoi(argv[++i]);
+        else if (!strcmp(a, "--beam") && hasValue)        cfg.botConfig.beamWidth = atoi(argv[++i]);
+        else if (!strcmp(a, "--threads") && hasValue)     cfg.threads = atoi(argv[++i]);
+        else if (!strcmp(a, "--seed") && hasValue)        cfg.seed = strtoull(argv[++i], nullptr, 10);
+        else if (!strcmp(a, "--checkpoint") && hasValue)  cfg.checkpoint = argv[++i];
+        else if (!strcmp(a, "--resume"))                  cfg.resume = true;
+        else {
+            fprintf(stderr, "Nieznany argument: %s\n", a);
+            return false;
+        }
+    }
+    return cfg.population > ELITE && cfg.games > 0 && cfg.generations > 0 && cfg.maxPieces > 0;
+}
+
+// --- Losowanie ---
+
+static float uniform01(Rng& r) {
+    return (float)(nextU32(r) >> 8) * (1.0f / 16777216.0f);
+}
+
+// rozkład normalny N(0, 1) metodą Boxa-Mullera
+static float gaussian(Rng& r) {
+    float u = 1.0f - uniform01(r);   // (0, 1], żeby log nie dostał zera
+    float v = uniform01(r);
+    return std::sqrt(-2.0f * std::log(u)) * std::cos(6.2831853f * v);
+}
+
+// Ocena jest liniowa w wagach, więc liczy się tylko ich kierunek –
+// trzymamy wektory jednostkowe
+static void normalize(EvalWeights& w) {
+    float len = 0;
+    for (int i = 0; i < FEAT_COUNT; ++i)
+        len += w.w[i] * w.w[i];
+    len = std::sqrt(len);
+    if (len > 0)
+        for (int i = 0; i < FEAT_COUNT; ++i)
+            w.w[i] /= len;
+}
+
+static std::vector<Candidate> initialPopulation(const TunerConfig& cfg) {
+    Rng r;
+    seedRng(r, cfg.seed);
+    std::vector<Candidate> pop(cfg.population);
+    // pierwszy kandydat to wagi domyślne, reszta losowa
+    for (int i = 1; i < cfg.population; ++i)
+        for (int f = 0; f < FEAT_COUNT; ++f)
+            pop[i].weights.w[f] = uniform01(r) * 2 - 1;
+    for (Candidate& c : pop)
+        normalize(c.weights);
+    return pop;
+}
+
+// --- Ocena kandydatów ---
+
+// Jedna gra bota z danymi wagami; wynik to liczba linii
+static int playGame(const TunerConfig& cfg, const EvalWeights& weights, uint64_t seed) {
+    BotConfig bc = cfg.botConfig;
+    bc.weights = weights;
+    Bot bot(bc);
+
+    Action actions[64];
+    GameState s;
+    resetBoard(s, seed);
+    spawnNewPiece(s);
+    while (!s.gameOver && s.pieces < cfg.maxPieces) {
+        int n = bot.think(s, actions, 64);
+        if (n == 0) {
+            actions[0] = ACT_HARD_DROP;
+            n = 1;
+        }
+        step(s, actions, n);
+    }
+    return s.lines;
+}
+
+// Wszyscy kandydaci grają te same gry pokolenia; zadaniem puli jest
+// jedna gra, więc rdzenie są zajęte także przy małej populacji
+static void evaluatePopulation(const TunerConfig& cfg, ThreadPool& pool, int generation,
+                               std::vector<Candidate>& pop, std::vector<int>& lines) {
+    int games = cfg.games;
+    lines.assign(pop.size() * games, 0);
+    pool.parallelFor((int)lines.size(), [&](int index, int) {
+        int c = index / games;
+        int g = index % games;
+        uint64_t seed = deriveSeed(cfg.seed, (uint64_t)generation * games + g);
+        lines[index] = playGame(cfg, pop[c].weights, seed);
+    });
+    for (size_t c = 0; c < pop.size(); ++c) {
+        int64_t sum = 0;
+        for (int g = 0; g < games; ++g)
+            sum += lines[c * games + g];
+        pop[c].fitness = (double)sum / games;
+    }
+}
+
+// --- Operatory genetyczne ---
+
+static const Candidate& tournament(const std::vector<Candidate>& pop, Rng& r) {
+    const Candidate* best = &pop[nextBelow(r, (uint32_t)pop.size())];
+    for (int i = 1; i < TOURNAMENT; ++i) {
+        const Candidate& c = pop[nextBelow(r, (uint32_t)pop.size())];
+        if (c.fitness > best->fitness)
+            best = &c;
+    }
+    return *best;
+}
+
+// Populacja posortowana malejąco po fitness -> następne pokolenie
+static std::vector<Candidate> nextGeneration(const TunerConfig& cfg, const std::vector<Candidate>& pop, int generation) {
+    Rng r;
+    seedRng(r, deriveSeed(cfg.seed, (uint64_t)generation));
+    std::vector<Candidate> next(pop.begin(), pop.begin() + ELITE);
+    while ((int)next.size() < cfg.population) {
+        const Candidate& a = tournament(pop, r);
+        const Candidate& b = tournament(pop, r);
+        // krzyżowanie: średnia ważona lepszym wynikiem (+1 – obaj z zerem liczą się po równo)
+        double fa = a.fitness + 1, fb = b.fitness + 1;
+        Candidate child;
+        for (int f = 0; f < FEAT_COUNT; ++f)
+            child.weights.w[f] = (float)((a.weights.w[f] * fa + b.weights.w[f] * fb) / (fa + fb));
+        if (uniform01(r) < MUTATION_RATE) {
+            int f = (int)nextBelow(r, FEAT_COUNT);
+            child.weights.w[f] += MUTATION_SIGMA * gaussian(r);
+        }
+        normalize(child.weights);
+        next.push_back(child);
+    }
+    return next;
+}
+
+// --- Plik kontrolny ---
+//
+//   tuner 2
+//   settings seed S games G pieces M depth D beam W
+//   generation G
+//   best F w0 w1 ...        (tylko gdy już jest)
+//   candidate w0 w1 ...     (P wierszy)
+//
+// Wagi jako %.9g, więc odczyt daje dokładnie te same floaty.
+
+static void writeWeights(FILE* f, const EvalWeights& w) {
+    for (int i = 0; i < FEAT_COUNT; ++i)
+        fprintf(f, " %.9g", w.w[i]);
+    fprintf(f, "\n");
+}
+
+static bool readWeights(FILE* f, EvalWeights& w) {
+    for (int i = 0; i < FEAT_COUNT; ++i)
+        if (fscanf(f, "%f", &w.w[i]) != 1)
+            return false;
+    return true;
+}
+
+// Zapis do pliku tymczasowego i zamiana nazwy – przerwanie w trakcie
+// zapisu nie psuje poprzedniego pliku kontrolnego
+static bool saveCheckpoint(const char* path, const TunerConfig& cfg, const TunerState& st) {
+    std::string tmp = std::string(path) + ".tmp";
+    FILE* f = fopen(tmp.c_str(), "w");
+    if (!f)
+        return false;
+    fprintf(f, "tuner 2\nsettings seed %llu games %d pieces %d depth %d beam %d\ngeneration %d\n",
+            (unsigned long long)cfg.seed, cfg.games, cfg.maxPieces, cfg.botConfig.depth,
+            cfg.botConfig.beamWidth, st.generation);
+    if (st.hasBest) {
+        fprintf(f, "best %.9g", st.best.fitness);
+        writeWeights(f, st.best.weights);
+    }
+    for (const Candidate& c : st.population) {
+        fprintf(f, "candidate");
+        writeWeights(f, c.weights);
+    }
+    bool ok = !ferror(f);
+    ok = fclose(f) == 0 && ok;
+    if (!ok)
+        return false;
+    remove(path);   // rename na Windows nie nadpisuje
+    return rename(tmp.c_str(), path) == 0;
+}
+
+static bool loadCheckpoint(const char* path, TunerConfig& cfg, TunerState& st) {
+    FILE* f = fopen(path, "r");
+    if (!f)
+        return false;
+    int version = 0;
+    unsigned long long seed = 0;
+    bool ok = fscanf(f, "tuner %d settings seed %llu games %d pieces %d depth %d beam %d generation %d",
+                     &version, &seed, &cfg.games, &cfg.maxPieces, &cfg.botConfig.depth,
+                     &cfg.botConfig.beamWidth, &st.generation) == 7 && version == 2;
+    cfg.seed = seed;
+    char tag[16];
+    while (ok && fscanf(f, "%15s", tag) == 1) {
+        if (!strcmp(tag, "best")) {
+            ok = fscanf(f, "%lf", &st.best.fitness) == 1 && readWeights(f, st.best.weights);
+            st.hasBest = true;
+        } else if (!strcmp(tag, "candidate")) {
+            Candidate c;
+            ok = readWeights(f, c.weights);
+            st.population.push_back(c);
+        } else {
+            ok = false;
+        }
+    }
+    fclose(f);
+    // jak w parseArgs: populacja musi być większa niż ELITE
+    return ok && (int)st.population.size() > ELITE && st.generation >= 0 && cfg.games > 0 &&
+           cfg.maxPieces > 0;
+}
+
+int main(int argc, char** argv) {
+    TunerConfig cfg;
+    if (!parseArgs(argc, argv, cfg)) {
+        fprintf(stderr, "Uzycie: %s [--population P] [--games G] [--generations N] [--max-pieces M]\n"
+                        "          [--depth D] [--beam W] [--threads T] [--seed S]\n"
+                        "          [--checkpoint plik] [--resume]\n", argv[0]);
+        return 1;
+    }
+
+    TunerState st;
+    if (cfg.resume) {
+        if (!loadCheckpoint(cfg.checkpoint, cfg, st)) {
+            fprintf(stderr, "Nie moge wczytac %s\n", cfg.checkpoint);
+            return 1;
+        }
+        cfg.population = (int)st.population.size();
+        printf("wznowienie: pokolenie %d, populacja %d, ziarno %llu\n", st.generation, cfg.population,
+               (unsigned long long)cfg.seed);
+    } else {
+        st.population = initialPopulation(cfg);
+    }
+
+    ThreadPool pool(cfg.threads);
+    printf("populacja %d, %d gier po %d figur, bot: glebokosc %d, wiazka %d, watki %d\n",
+           cfg.population, cfg.games, cfg.maxPieces, cfg.botConfig.depth, cfg.botConfig.beamWidth,
+           pool.threadCount());
+
+    std::vector<int> lines;
+    auto t0 = std::chrono::steady_clock::now();
+    int done = 0;
+    for (; st.generation < cfg.generations; ++done) {
+        evaluatePopulation(cfg, pool, st.generation, st.population, lines);
+        std::stable_sort(st.population.begin(), st.population.end(),
+                         [](const Candidate& a, const Candidate& b) { return a.fitness > b.fitness; });
+
+        double mean = 0;
+        for (const Candidate& c : st.population)
+            mean += c.fitness;
+        mean /= st.population.size();
+        const Candidate& top = st.population[0];
+        if (!st.hasBest || top.fitness > st.best.fitness) {
+            st.best = top;
+            st.hasBest = true;
+        }
+
+        double hours = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count() / 3600.0;
+        printf("pokolenie %3d  najlepszy %8.1f  srednia %8.1f  pokolen/h %.0f  wagi",
+               st.generation, top.fitness, mean, (done + 1) / hours);
+        for (int i = 0; i < FEAT_COUNT; ++i)
+            printf(" %.3f", top.weights.w[i]);
+        printf("\n");
+        fflush(stdout);
+
+        st.population = nextGeneration(cfg, st.population, st.generation);
+        ++st.generation;
+        if (!saveCheckpoint(cfg.checkpoint, cfg, st))
+            fprintf(stderr, "Nie moge zapisac %s\n", cfg.checkpoint);
+    }
+
+    if (st.hasBest) {
+        printf("najlepsze wagi (%.1f linii): {", st.best.fitness);
+        for (int i = 0; i < FEAT_COUNT; ++i)
+            printf("%s%.6gf", i ? ", " : " ", st.best.weights.w[i]);
+        printf(" }\n");
+    }
+    return 0;
+}